@@ -0,0 +1,44 @@
+#include "adjudication.hpp"
+
+#include <algorithm>
+
+namespace pyrisk {
+
+int classic_starting_armies(std::size_t players, std::size_t territories) {
+    if (players == 0) {
+        return 0;
+    }
+    int classic = 35 - 2 * static_cast<int>(players);
+    int share = static_cast<int>((territories + players - 1) / players);
+    return std::max(classic, share);
+}
+
+double score_territories(const Game& game, const Player& player) {
+    return static_cast<double>(game.territory_count(player));
+}
+
+double score_forces(const Game& game, const Player& player) {
+    int total = 0;
+    for (const auto* territory : game.world.territory_list) {
+        if (territory->owner == &player) {
+            total += territory->forces;
+        }
+    }
+    return static_cast<double>(total);
+}
+
+double score_continents(const Game& game, const Player& player) {
+    double score = 0.0;
+    for (const auto* area : game.world.area_list) {
+        int held = 0;
+        for (const auto* territory : area->territories) {
+            if (territory->owner == &player) {
+                ++held;
+            }
+        }
+        score += area->value * static_cast<double>(held) / static_cast<double>(area->territories.size());
+    }
+    return score;
+}
+
+}  // namespace pyrisk
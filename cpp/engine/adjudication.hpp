@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+#include "game.hpp"
+
+namespace pyrisk {
+
+// Upper bounds on a game's length. Zero means unlimited. Turns count player
+// turns after initial placement; events count board actions (claims,
+// reinforcements, moves, battles) whether or not anyone logs them.
+// max_wall is a safety net rather than a rule of the game: it is checked
+// between main-phase turns, counted from play() or resume(), and a game
+// that overruns it throws std::runtime_error instead of being adjudicated.
+struct GameLimits {
+    std::size_t max_turns{0};
+    std::size_t max_events{0};
+    std::chrono::milliseconds max_wall{0};
+};
+
+// Armies each player starts with, placed during initial placement. Must be
+// at least enough to claim an even share of the territories.
+using StartingArmies = std::function<int(std::size_t players, std::size_t territories)>;
+
+// The original 35 - 2 * players, raised to an even share of the map when
+// that alone would not cover it (large lobbies, big generated maps).
+int classic_starting_armies(std::size_t players, std::size_t territories);
+
+// Scores a surviving player when a game is adjudicated; highest score wins.
+using Scorer = std::function<double(const Game&, const Player&)>;
+
+double score_territories(const Game& game, const Player& player);
+double score_forces(const Game& game, const Player& player);
+// Sum of area values weighted by the fraction of each area the player holds.
+double score_continents(const Game& game, const Player& player);
+
+}  // namespace pyrisk
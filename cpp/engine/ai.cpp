@@ -1,14 +1,26 @@
 #include "ai.hpp"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <mutex>
 #include <numeric>
+#include <ostream>
+#include <shared_mutex>
 #include <stdexcept>
-#include <tuple>
-#include <unordered_set>
+
+#include "binary_io.hpp"
+#include "statistics.hpp"
 
 namespace pyrisk {
 namespace {
 
+constexpr char kCheckpointMagic[4] = {'P', 'R', 'C', 'K'};
+constexpr std::uint64_t kCheckpointVersion = 1;
+
 std::vector<Player> make_players(const std::vector<std::string>& names) {
     std::vector<Player> players;
     players.reserve(names.size());
@@ -18,17 +30,289 @@ std::vector<Player> make_players(const std::vector<std::string>& names) {
     return players;
 }
 
-int remaining_total(const std::unordered_map<std::string, int>& remaining) {
-    return std::accumulate(
-        remaining.begin(), remaining.end(), 0,
-        [](int acc, const auto& entry) { return acc + entry.second; });
+struct RoundOutcome {
+    int attackers_lost;
+    int defenders_lost;
+    double probability;
+};
+
+// Outcomes of one round of dice, by [attacking dice - 1][defending dice - 1].
+using RoundTable = std::array<std::array<std::vector<RoundOutcome>, 2>, 3>;
+
+const RoundTable& dice_rounds() {
+    static const RoundTable table = []() {
+        RoundTable out;
+        for (int atk = 1; atk <= 3; ++atk) {
+            for (int def = 1; def <= 2; ++def) {
+                int rolls = 1;
+                for (int i = 0; i < atk + def; ++i) {
+                    rolls *= 6;
+                }
+                std::array<int, 3> by_defenders_lost{};
+                std::vector<int> atk_roll(static_cast<std::size_t>(atk));
+                std::vector<int> def_roll(static_cast<std::size_t>(def));
+                for (int roll = 0; roll < rolls; ++roll) {
+                    int rest = roll;
+                    for (auto& die : atk_roll) {
+                        die = rest % 6;
+                        rest /= 6;
+                    }
+                    for (auto& die : def_roll) {
+                        die = rest % 6;
+                        rest /= 6;
+                    }
+                    std::sort(atk_roll.begin(), atk_roll.end(), std::greater<int>());
+                    std::sort(def_roll.begin(), def_roll.end(), std::greater<int>());
+                    int defenders_lost = 0;
+                    for (int i = 0; i < std::min(atk, def); ++i) {
+                        defenders_lost += atk_roll[static_cast<std::size_t>(i)] >
+                                          def_roll[static_cast<std::size_t>(i)];
+                    }
+                    ++by_defenders_lost[static_cast<std::size_t>(defenders_lost)];
+                }
+                auto& outcomes = out[static_cast<std::size_t>(atk - 1)][static_cast<std::size_t>(def - 1)];
+                for (int lost = 0; lost <= std::min(atk, def); ++lost) {
+                    outcomes.push_back({std::min(atk, def) - lost, lost,
+                                        static_cast<double>(by_defenders_lost[static_cast<std::size_t>(lost)]) / rolls});
+                }
+            }
+        }
+        return out;
+    }();
+    return table;
+}
+
+// Probability mass over the defender counts [lo, lo + mass.size()) of one
+// anti-diagonal of the battle grid.
+struct Diagonal {
+    // Widens the window to cover [from, to], keeping existing mass.
+    void cover(int from, int to) {
+        if (mass.empty()) {
+            lo = from;
+            mass.assign(static_cast<std::size_t>(to - from + 1), 0.0);
+            return;
+        }
+        if (from < lo) {
+            mass.insert(mass.begin(), static_cast<std::size_t>(lo - from), 0.0);
+            lo = from;
+        }
+        if (to >= lo + static_cast<int>(mass.size())) {
+            mass.resize(static_cast<std::size_t>(to - lo + 1), 0.0);
+        }
+    }
+
+    // `d` must already be covered.
+    void add(int d, double p) { mass[static_cast<std::size_t>(d - lo)] += p; }
+
+    void trim(double negligible) {
+        std::size_t first = 0;
+        while (first < mass.size() && mass[first] < negligible) {
+            ++first;
+        }
+        while (mass.size() > first && mass.back() < negligible) {
+            mass.pop_back();
+        }
+        mass.erase(mass.begin(), mass.begin() + static_cast<long>(first));
+        lo += static_cast<int>(first);
+    }
+
+    void clear() { mass.clear(); }
+
+    int lo{0};
+    std::vector<double> mass;
+};
+
+// Probability mass below this is dropped from battle odds.
+constexpr double kNegligible = 1e-13;
+
+// Battles with more armies than this use large_battle_odds(): the exact
+// grid grows with the square of the stacks, and ChronAI probes many sizes.
+constexpr int kExactBattleArmies = 500;
+
+// Probability that a round of `atk` against `def` dice costs the attacker
+// `lost` armies.
+double round_probability(int atk, int def, int lost) {
+    double p = 0.0;
+    for (const auto& outcome : dice_rounds()[static_cast<std::size_t>(atk - 1)]
+                                            [static_cast<std::size_t>(def - 1)]) {
+        if (outcome.attackers_lost == lost) {
+            p += outcome.probability;
+        }
+    }
+    return p;
+}
+
+// Limit of a long battle of three dice against two. Each round costs the
+// attacker X armies and the defender 2 - X, so a side's losses by the time
+// the other side runs out are twice a renewal count less the armies spent,
+// which is close to normal; a one-term Edgeworth correction takes care of
+// the skew in the tails. The last rounds, once the losing side rolls fewer
+// dice, are added exactly: a side whose losses come one or two at a time
+// lands on its last full-dice count (3 attackers, 1 defender) with
+// probability 1 / E[loss | loss > 0] and otherwise skips it. Against the
+// exact odds for 500 to 2400 armies this keeps victory within 0.006 and the
+// survivors within 0.35 of an army, wherever the side survives one battle
+// in a thousand.
+BattleOdds large_battle_odds(int n_atk, int n_def) {
+    double mean = 0.0;
+    for (const auto& outcome : dice_rounds()[2][1]) {
+        mean += outcome.probability * outcome.attackers_lost;
+    }
+    double variance = 0.0;
+    double skew = 0.0;  // third central moment of X
+    for (const auto& outcome : dice_rounds()[2][1]) {
+        double x = outcome.attackers_lost - mean;
+        variance += outcome.probability * x * x;
+        skew += outcome.probability * x * x * x;
+    }
+    double other = 2.0 - mean;
+    double none = round_probability(3, 2, 0);
+    double one = round_probability(3, 2, 1);
+    double two = round_probability(3, 2, 2);
+
+    // Losses with cumulants (centre, spread^2, third) counted up to `limit`:
+    // the probability and the mean of the losses given they stay under it.
+    struct Tail {
+        double probability;
+        double mean;
+    };
+    auto below = [](double centre, double spread, double third, double limit) {
+        // The losses move in steps of two, and half the usual Edgeworth
+        // term is what matches the exact odds.
+        double gamma = 0.5 * third / (spread * spread * spread);
+        double z = (limit - centre) / spread;
+        double density = std::exp(-z * z / 2) / std::sqrt(2.0 * std::acos(-1.0));
+        double p = 0.5 * std::erfc(-z / std::sqrt(2.0)) - gamma / 6 * density * (z * z - 1);
+        p = std::clamp(p, 0.0, 1.0);
+        double shortfall = spread * density * (1 + gamma * z * z * z / 6);
+        // Far out in the tail the correction overshoots; the losses that
+        // stay under the limit cannot average more than the limit.
+        return Tail{p, p > kNegligible ? std::min(centre - shortfall / p, limit) : 0.0};
+    };
+    // Renewal counts to `t` with steps of mean m: variance t var / m^3 and
+    // third cumulant t (3 var^2 - m k3) / m^5; losses are twice the count.
+    auto cumulants = [&](double t, double m, double k3, double& spread, double& third) {
+        spread = std::sqrt(4.0 * t * variance / (m * m * m));
+        third = 8.0 * t * (3.0 * variance * variance - m * k3) / std::pow(m, 5);
+    };
+
+    BattleOdds odds;
+    double spread = 0.0;
+    double third = 0.0;
+    // Attacker losses when the defence is gone: the full-dice rounds take
+    // the defence to one army or straight to none, and a last defender
+    // rolling one die costs L / (1 - L) more, L = P(attacker loses) at 3v1.
+    double last = (one + none) / (one + 2.0 * none);
+    double single = round_probability(3, 1, 1);
+    double lost = mean * (n_def - last) / other + last * single / (1.0 - single);
+    cumulants(n_def, other, -skew, spread, third);
+    // The attack wins with at most n_atk - 2 lost; cutting at n_atk - 2
+    // rather than halfway to the next loss fits the exact odds best.
+    Tail tail = below(lost, spread, third, n_atk - 2.0);
+    odds.victory = tail.probability;
+    if (odds.victory > kNegligible) {
+        odds.attackers = n_atk - tail.mean;
+    }
+    // Defender losses when the attackers are down to one: the full-dice
+    // rounds end on three attackers or two, and the rest is fought with two
+    // dice and then one against two.
+    last = (one + two) / (one + 2.0 * two);
+    double from_two = round_probability(1, 2, 0) / round_probability(1, 2, 1);
+    double hold = round_probability(2, 2, 0);
+    double split = round_probability(2, 2, 1);
+    double from_three = (split * (1.0 + from_two) + 2.0 * hold) / (1.0 - hold);
+    lost = other * (n_atk - 2.0 - last) / mean + last * from_three + (1.0 - last) * from_two;
+    cumulants(n_atk - 1, mean, skew, spread, third);
+    // The defence holds with at most n_def - 1 lost.
+    tail = below(lost, spread, third, n_def - 0.5);
+    if (tail.probability > kNegligible) {
+        odds.defenders = n_def - tail.mean;
+    }
+    return odds;
 }
 
+std::shared_mutex battle_cache_mutex;
+std::unordered_map<std::uint64_t, BattleOdds> battle_cache;
+
 }  // namespace
 
 AI::AI(Player& player, Game& game)
     : player_(player), game_(game), world_(game.world), rng_(game.rng()) {}
 
+BattleOdds AI::battle_odds(int n_atk, int n_def) {
+    if (n_atk > 1 && n_def > 0 && n_atk + n_def > kExactBattleArmies) {
+        return large_battle_odds(n_atk, n_def);
+    }
+    auto key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(n_atk)) << 32) |
+               static_cast<std::uint32_t>(n_def);
+    {
+        std::shared_lock<std::shared_mutex> lock(battle_cache_mutex);
+        auto it = battle_cache.find(key);
+        if (it != battle_cache.end()) {
+            return it->second;
+        }
+    }
+
+    // Push probability mass from (n_atk, n_def) through every dice round,
+    // one anti-diagonal (attackers + defenders) at a time. Each round removes
+    // one or two armies, so only three diagonals are live, and negligible
+    // mass at the edges of each is dropped to keep long battles cheap.
+    const auto& rounds = dice_rounds();
+    std::array<Diagonal, 3> diagonals;
+    int total = std::max(n_atk, 0) + std::max(n_def, 0);
+    diagonals[static_cast<std::size_t>(total % 3)].cover(std::max(n_def, 0), std::max(n_def, 0));
+    diagonals[static_cast<std::size_t>(total % 3)].add(std::max(n_def, 0), 1.0);
+
+    BattleOdds odds;
+    double lost = 0.0;
+    for (int t = total; t >= 0; --t) {
+        Diagonal& here = diagonals[static_cast<std::size_t>(t % 3)];
+        here.trim(kNegligible);
+        if (here.mass.empty()) {
+            continue;
+        }
+        int hi = here.lo + static_cast<int>(here.mass.size()) - 1;
+        for (int step = 1; step <= 2 && step <= t; ++step) {
+            diagonals[static_cast<std::size_t>((t - step) % 3)].cover(std::max(here.lo - step, 0), hi);
+        }
+        for (std::size_t i = 0; i < here.mass.size(); ++i) {
+            double p = here.mass[i];
+            int d = here.lo + static_cast<int>(i);
+            int a = t - d;
+            if (p == 0.0) {
+                continue;
+            }
+            if (d == 0) {
+                odds.victory += p;
+                odds.attackers += p * a;
+                continue;
+            }
+            if (a <= 1) {
+                lost += p;
+                odds.defenders += p * d;
+                continue;
+            }
+            for (const auto& outcome : rounds[static_cast<std::size_t>(std::min(a - 1, 3) - 1)]
+                                             [static_cast<std::size_t>(std::min(d, 2) - 1)]) {
+                int next = t - outcome.attackers_lost - outcome.defenders_lost;
+                diagonals[static_cast<std::size_t>(next % 3)].add(d - outcome.defenders_lost,
+                                                                  p * outcome.probability);
+            }
+        }
+        here.clear();
+    }
+    odds.attackers = odds.victory > 0.0 ? odds.attackers / odds.victory : 0.0;
+    odds.defenders = lost > 0.0 ? odds.defenders / lost : 0.0;
+
+    std::unique_lock<std::shared_mutex> lock(battle_cache_mutex);
+    battle_cache.emplace(key, odds);
+    return odds;
+}
+
+bool AI::charge_nodes(std::uint64_t nodes) {
+    return decision_ != nullptr && decision_->charge(nodes);
+}
+
 std::vector<Territory*> AI::owned_territories() const { return owned_territories(player_); }
 
 std::vector<Territory*> AI::owned_territories(const Player& player) const {
@@ -57,31 +341,34 @@ Territory* StupidAI::initial_placement(const std::vector<Territory*>& empty, int
 
 std::unordered_map<Territory*, int> StupidAI::reinforce(int available) {
     std::unordered_map<Territory*, int> allocations;
-    std::vector<Territory*> borders;
-    for (auto* territory : owned_territories(player_)) {
-        if (territory->border()) {
-            borders.push_back(territory);
-        }
-    }
-    if (borders.empty()) {
-        borders = owned_territories(player_);
+    std::vector<Territory*> owned;
+    const std::vector<Territory*>* borders = &frontier();
+    if (borders->empty()) {
+        owned = owned_territories(player_);
+        borders = &owned;
     }
-    if (borders.empty()) {
+    if (borders->empty()) {
         return allocations;
     }
 
-    for (int i = 0; i < available; ++i) {
-        int idx = rng_.randbelow(static_cast<int>(borders.size()));
-        allocations[borders[static_cast<std::size_t>(idx)]] += 1;
+    // The driver places whatever is left when the budget cuts this short.
+    for (int i = 0; i < available && !charge_nodes(); ++i) {
+        int idx = rng_.randbelow(static_cast<int>(borders->size()));
+        allocations[(*borders)[static_cast<std::size_t>(idx)]] += 1;
     }
     return allocations;
 }
 
 std::vector<AttackPlan> StupidAI::attack() {
+    // Only frontier territories have enemy neighbours once the board is
+    // claimed, which it always is by the attack phase.
     std::vector<AttackPlan> plans;
-    for (auto* territory : owned_territories(player_)) {
-        for (auto* adjacent : territory->connect) {
-            if (adjacent->owner != &player_ && territory->forces > adjacent->forces) {
+    for (auto* territory : frontier()) {
+        if (charge_nodes()) {
+            break;
+        }
+        for (auto* adjacent : territory->neighbours(Side::Hostile)) {
+            if (territory->forces > adjacent->forces) {
                 plans.push_back({territory, adjacent, {}, {}});
             }
         }
@@ -89,50 +376,40 @@ std::vector<AttackPlan> StupidAI::attack() {
     return plans;
 }
 
-std::vector<Territory*> DeterministicAI::sorted_owned() const {
-    std::vector<Territory*> owned = owned_territories(player_);
-    std::sort(owned.begin(), owned.end(), [](Territory* lhs, Territory* rhs) {
-        return lhs->name < rhs->name;
-    });
-    return owned;
+std::vector<Territory*> DeterministicAI::sorted_frontier() const {
+    std::vector<Territory*> sorted = frontier();
+    std::sort(sorted.begin(), sorted.end(), by_name);
+    return sorted;
 }
 
 std::vector<Territory*> DeterministicAI::reinforce_targets() const {
-    std::vector<Territory*> borders;
-    for (auto* territory : owned_territories(player_)) {
-        if (territory->border()) {
-            borders.push_back(territory);
-        }
-    }
+    std::vector<Territory*> borders = frontier();
     if (borders.empty()) {
         borders = owned_territories(player_);
     }
 
-    std::sort(borders.begin(), borders.end(), [](Territory* lhs, Territory* rhs) {
-        auto pressure = [](Territory* t) {
-            int enemy_force = 0;
-            for (auto* adj : t->connect) {
-                if (adj->owner != nullptr && adj->owner != t->owner) {
-                    enemy_force += adj->forces;
-                }
-            }
-            return std::make_tuple(-enemy_force, -t->forces, t->name);
-        };
-        return pressure(lhs) < pressure(rhs);
+    // Most enemy pressure first, then most forces, then by name.
+    std::sort(borders.begin(), borders.end(), [this](Territory* lhs, Territory* rhs) {
+        int lhs_enemy = enemy_forces(*lhs);
+        int rhs_enemy = enemy_forces(*rhs);
+        if (lhs_enemy != rhs_enemy) {
+            return lhs_enemy > rhs_enemy;
+        }
+        if (lhs->forces != rhs->forces) {
+            return lhs->forces > rhs->forces;
+        }
+        return lhs->name_rank < rhs->name_rank;
     });
     return borders;
 }
 
 Territory* DeterministicAI::initial_placement(const std::vector<Territory*>& empty,
                                               int /*remaining*/) {
-    std::vector<Territory*> choices = empty;
-    if (choices.empty()) {
-        choices = owned_territories(player_);
+    if (!empty.empty()) {
+        return *std::min_element(empty.begin(), empty.end(), by_name);
     }
-    std::sort(choices.begin(), choices.end(), [](Territory* lhs, Territory* rhs) {
-        return lhs->name < rhs->name;
-    });
-    return choices.empty() ? nullptr : choices.front();
+    auto owned = owned_territories(player_);
+    return owned.empty() ? nullptr : *std::min_element(owned.begin(), owned.end(), by_name);
 }
 
 std::unordered_map<Territory*, int> DeterministicAI::reinforce(int available) {
@@ -141,7 +418,10 @@ std::unordered_map<Territory*, int> DeterministicAI::reinforce(int available) {
     if (targets.empty()) {
         return allocations;
     }
-    for (int i = 0; i < available; ++i) {
+    if (params_.reinforce_spread > 0 && targets.size() > params_.reinforce_spread) {
+        targets.resize(params_.reinforce_spread);
+    }
+    for (int i = 0; i < available && !charge_nodes(); ++i) {
         Territory* target = targets[static_cast<std::size_t>(i % targets.size())];
         allocations[target] += 1;
     }
@@ -150,21 +430,26 @@ std::unordered_map<Territory*, int> DeterministicAI::reinforce(int available) {
 
 std::vector<AttackPlan> DeterministicAI::attack() {
     std::vector<AttackPlan> plans;
-    std::unordered_set<std::string> targeted;
-    for (auto* territory : sorted_owned()) {
-        std::vector<Territory*> adjacent(territory->connect.begin(), territory->connect.end());
-        std::sort(adjacent.begin(), adjacent.end(), [](Territory* lhs, Territory* rhs) {
-            return lhs->name < rhs->name;
-        });
+    std::vector<bool> targeted(game_.world.territory_list.size(), false);
+    std::vector<Territory*> adjacent;
+    for (auto* territory : sorted_frontier()) {
+        if (charge_nodes()) {
+            break;
+        }
+        auto hostile = territory->neighbours(Side::Hostile);
+        adjacent.assign(hostile.begin(), hostile.end());
+        std::sort(adjacent.begin(), adjacent.end(), by_name);
         for (auto* neighbour : adjacent) {
-            if (neighbour->owner != &player_ && territory->forces > neighbour->forces + 1) {
-                if (targeted.count(neighbour->name) > 0) {
+            if (territory->forces > params_.attack_ratio * neighbour->forces + params_.attack_margin) {
+                if (targeted[neighbour->index]) {
                     continue;
                 }
+                double margin = params_.continue_margin;
+                int cap = params_.move_cap;
                 plans.push_back({territory, neighbour,
-                                 [](int atk, int def) { return atk > def; },
-                                 [](int remaining) { return std::min(remaining - 1, 3); }});
-                targeted.insert(neighbour->name);
+                                 [margin](int atk, int def) { return atk > def + margin; },
+                                 [cap](int remaining) { return std::min(remaining - 1, cap); }});
+                targeted[neighbour->index] = true;
             }
         }
     }
@@ -176,28 +461,259 @@ GameDriver::GameDriver(World world, std::vector<std::string> player_names,
                        std::optional<std::uint32_t> seed)
     : game_(std::move(world), make_players(player_names), {}, seed),
       deal_(deal),
-      external_logger_(std::move(logger)) {
+      external_logger_(std::move(logger)),
+      decision_stats_(player_names.size()) {
     if (player_names.size() != ai_factories.size()) {
         throw std::invalid_argument("player count must match AI factory count");
     }
 
     ais_.reserve(ai_factories.size());
+    ai_events_.reserve(ai_factories.size());
     for (std::size_t i = 0; i < ai_factories.size(); ++i) {
         ais_.push_back(ai_factories[i](game_.players[i], game_));
+        ai_events_.push_back(ais_.back()->subscribed_events());
     }
 
-    game_.set_logger([this](const Event& event) { dispatch_event(event); });
+    update_subscriptions();
 }
 
 Game& GameDriver::game() { return game_; }
 const Game& GameDriver::game() const { return game_; }
 
+void GameDriver::set_decision_budget(DecisionBudget budget, ThreadPool* pool) {
+    budget_ = budget;
+    pool_ = pool;
+}
+
+const std::vector<DecisionStats>& GameDriver::decision_stats() const { return decision_stats_; }
+
+void GameDriver::set_logger_events(EventMask events) {
+    logger_events_ = events;
+    update_subscriptions();
+}
+
+void GameDriver::set_statistics(GameStatistics* statistics) { statistics_ = statistics; }
+
+void GameDriver::set_trace(TraceRecorder* trace) { trace_ = trace; }
+
+void GameDriver::set_limits(GameLimits limits, Scorer scorer) {
+    limits_ = limits;
+    scorer_ = std::move(scorer);
+}
+
+const GameResult& GameDriver::result() const { return result_; }
+
+void GameDriver::set_starting_armies(StartingArmies rule) { starting_armies_ = std::move(rule); }
+
+void GameDriver::set_turn_hook(TurnHook hook) { turn_hook_ = std::move(hook); }
+
+void GameDriver::save_checkpoint(std::ostream& out, bool with_ai_state) const {
+    if (!in_main_phase_) {
+        throw std::logic_error("checkpoints can only be saved between main-phase turns");
+    }
+    out.write(kCheckpointMagic, sizeof(kCheckpointMagic));
+    write_varint(out, kCheckpointVersion);
+    write_varint(out, game_.players.size());
+    for (const auto& player : game_.players) {
+        write_string(out, player.name);
+    }
+    PackedState board(game_, turn_state());
+    write_string(out, std::string(board.bytes().begin(), board.bytes().end()));
+    write_varint(out, main_turns_);
+    write_varint(out, first_conquest_round_ ? *first_conquest_round_ + 1 : 0);
+    write_varint(out, game_.event_count());
+    game_.rng().save(out);
+    write_varint(out, with_ai_state ? 1 : 0);
+    if (with_ai_state) {
+        for (const auto& ai : ais_) {
+            write_string(out, ai->save_state());
+        }
+    }
+    if (!out) {
+        throw std::runtime_error("failed to write checkpoint");
+    }
+}
+
+void GameDriver::load_checkpoint(std::istream& in) {
+    char magic[sizeof(kCheckpointMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kCheckpointMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("not a checkpoint");
+    }
+    if (read_varint(in) != kCheckpointVersion) {
+        throw std::runtime_error("unsupported checkpoint version");
+    }
+    if (read_varint(in) != game_.players.size()) {
+        throw std::runtime_error("checkpoint is for a different number of players");
+    }
+    for (const auto& player : game_.players) {
+        if (read_string(in) != player.name) {
+            throw std::runtime_error("checkpoint is for different players");
+        }
+    }
+    std::string board = read_string(in);
+    std::size_t main_turns = static_cast<std::size_t>(read_varint(in));
+    std::uint64_t first_conquest = read_varint(in);
+    std::size_t event_count = static_cast<std::size_t>(read_varint(in));
+    PythonicRNG rng;
+    rng.load(in);
+    std::optional<std::vector<std::string>> ai_state;
+    if (read_varint(in) != 0) {
+        ai_state.emplace();
+        for (std::size_t i = 0; i < ais_.size(); ++i) {
+            ai_state->push_back(read_string(in));
+        }
+    }
+
+    // Everything is read; only the board and seat order are left to check.
+    restore_board(PackedState::from_bytes(std::vector<std::uint8_t>(board.begin(), board.end())));
+    main_turns_ = main_turns;
+    first_conquest_round_.reset();
+    if (first_conquest != 0) {
+        first_conquest_round_ = static_cast<std::size_t>(first_conquest - 1);
+    }
+    game_.set_event_count(event_count);
+    game_.rng() = rng;
+    restored_ai_state_ = std::move(ai_state);
+    restored_ = true;
+    in_main_phase_ = true;
+    paused_ = false;
+}
+
+void GameDriver::set_position(const PackedState& position) {
+    restore_board(position);
+    main_turns_ = 0;
+    first_conquest_round_.reset();
+    restored_ai_state_.reset();
+    restored_ = true;
+    in_main_phase_ = true;
+    paused_ = false;
+}
+
+void GameDriver::restore_board(const PackedState& position) {
+    PackedState previous(game_, turn_state());
+    TurnState turn;
+    position.apply(game_, turn);
+    std::vector<std::size_t> seats = turn.seat_order;
+    std::sort(seats.begin(), seats.end());
+    for (std::size_t i = 0; i < game_.players.size(); ++i) {
+        if (seats.size() != game_.players.size() || seats[i] != i) {
+            TurnState ignored;
+            previous.apply(game_, ignored);
+            throw std::runtime_error("seat order is not a permutation of the players");
+        }
+    }
+    turn_ = turn.turn;
+    turn_order_ = std::move(turn.seat_order);
+    assign_seats();
+}
+
+bool GameDriver::limits_reached(std::size_t main_turns) const {
+    return (limits_.max_turns != 0 && main_turns >= limits_.max_turns) ||
+           (limits_.max_events != 0 && game_.event_count() >= limits_.max_events);
+}
+
+Player* GameDriver::adjudicate() {
+    // Ties go to more territories, then to the earlier seat.
+    Player* best = nullptr;
+    double best_score = 0.0;
+    int best_territories = 0;
+    for (auto index : turn_order_) {
+        auto& player = game_.players[index];
+        int territories = game_.territory_count(player);
+        if (territories == 0) {
+            continue;
+        }
+        double score = scorer_(game_, player);
+        if (best == nullptr || score > best_score ||
+            (score == best_score && territories > best_territories)) {
+            best = &player;
+            best_score = score;
+            best_territories = territories;
+        }
+    }
+    return best;
+}
+
+void GameDriver::update_subscriptions() {
+    EventMask wanted = external_logger_ ? logger_events_ : kNoEvents;
+    for (auto events : ai_events_) {
+        wanted |= events;
+    }
+    if (wanted == kNoEvents) {
+        game_.set_logger({});
+    } else {
+        game_.set_logger([this](const Event& event) { dispatch_event(event); }, wanted);
+    }
+}
+
+std::size_t GameDriver::seat_of(const Player& player) const {
+    return static_cast<std::size_t>(&player - game_.players.data());
+}
+
+template <typename Decide, typename Fallback>
+auto GameDriver::decide(const Player& player, const char* what, Decide&& decide, Fallback&& fallback)
+    -> std::invoke_result_t<Decide&> {
+    using Result = std::invoke_result_t<Decide&>;
+    std::size_t seat = seat_of(player);
+    AI& ai = *ais_[seat];
+    auto& stats = decision_stats_[seat];
+
+    decision_context_.begin(budget_);
+    ai.set_decision_context(&decision_context_);
+    std::optional<Result> result;
+    bool gave_up = false;
+    // Timed and traced where the AI runs: a driver waiting on the pool may
+    // run other games' tasks meanwhile, and their time is not this AI's.
+    DecisionContext::Clock::time_point started;
+    DecisionContext::Clock::time_point finished;
+    auto traced = [&]() {
+        TraceSpan span(trace_, "ai", what, "seat", static_cast<std::int64_t>(seat_of_player_[seat]));
+        started = DecisionContext::Clock::now();
+        auto answer = decide();
+        finished = DecisionContext::Clock::now();
+        return answer;
+    };
+    if (pool_ != nullptr) {
+        auto future = pool_->submit(traced, ThreadPool::Priority::High);
+        if (decision_context_.has_deadline() &&
+            pool_->wait_until(future, decision_context_.deadline()) ==
+                std::future_status::timeout) {
+            // The AI still reads the board, so let it notice the cancellation
+            // and return before the game moves on. Its answer is then too late.
+            decision_context_.cancel();
+            gave_up = true;
+        }
+        pool_->wait(future);
+        result.emplace(future.get());
+    } else {
+        result.emplace(traced());
+    }
+    ai.set_decision_context(nullptr);
+
+    stats.latency.record(finished - started);
+    stats.nodes += decision_context_.nodes();
+    if (gave_up) {
+        ++stats.timeouts;
+        return fallback();
+    }
+    // An answer in hand when the driver stopped waiting is kept, even if it
+    // overran the budget or was cut short by it.
+    if (decision_context_.cancelled() ||
+        (decision_context_.has_deadline() && finished > decision_context_.deadline())) {
+        ++stats.over_budget;
+    }
+    return std::move(*result);
+}
+
 void GameDriver::dispatch_event(const Event& event) {
-    if (external_logger_) {
+    EventMask bit = event_bit(event.kind);
+    if (external_logger_ && (logger_events_ & bit) != 0) {
         external_logger_(event);
     }
-    for (auto& ai : ais_) {
-        ai->on_event(event);
+    for (std::size_t i = 0; i < ais_.size(); ++i) {
+        if ((ai_events_[i] & bit) != 0) {
+            ais_[i]->on_event(event);
+        }
     }
 }
 
@@ -207,17 +723,30 @@ Player& GameDriver::current_player() {
 
 AI& GameDriver::current_ai() { return *ais_[turn_order_[turn_ % turn_order_.size()]]; }
 
+void GameDriver::advance_turn(std::size_t turns) {
+    turn_ += turns;
+    game_.set_to_move(&current_player());
+}
+
 void GameDriver::setup_turn_order() {
     turn_order_.resize(game_.players.size());
     std::iota(turn_order_.begin(), turn_order_.end(), 0);
     game_.rng().shuffle(turn_order_.begin(), turn_order_.end());
+    assign_seats();
+}
 
-    static const std::vector<char> ords = {'\\', '/', '-', '|', '+'};
+void GameDriver::assign_seats() {
+    // The original five, then enough for a 64-player lobby.
+    static const std::string ords =
+        "\\/-|+ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    seat_of_player_.resize(turn_order_.size());
     for (std::size_t i = 0; i < turn_order_.size(); ++i) {
         auto& player = game_.players[turn_order_[i]];
         player.color = static_cast<int>(i) + 1;
         player.ord = i < ords.size() ? ords[i] : '*';
+        seat_of_player_[turn_order_[i]] = i;
     }
+    game_.set_to_move(&current_player());
 }
 
 std::string GameDriver::play() {
@@ -225,30 +754,120 @@ std::string GameDriver::play() {
     for (auto& ai : ais_) {
         ai->start();
     }
-    dispatch_event({"start", {}});
+    if (game_.wants(EventKind::Start)) {
+        dispatch_event({EventKind::Start, event_name(EventKind::Start), {}});
+    }
 
     initial_placement();
 
+    main_turns_ = 0;
+    first_conquest_round_.reset();
+    return play_main_phase();
+}
+
+void GameDriver::reset(std::uint32_t seed) {
+    game_.reset(seed);
+    std::iota(turn_order_.begin(), turn_order_.end(), 0);
+    turn_ = 0;
+    main_turns_ = 0;
+    first_conquest_round_.reset();
+    in_main_phase_ = false;
+    paused_ = false;
+    restored_ai_state_.reset();
+    restored_ = false;
+    result_.winner.clear();
+    result_.adjudicated = false;
+    result_.turns = 0;
+    std::fill(decision_stats_.begin(), decision_stats_.end(), DecisionStats{});
+    for (auto& ai : ais_) {
+        ai->reset();
+    }
+}
+
+std::string GameDriver::resume() {
+    if (restored_) {
+        // The AIs have not seen this game: start them as play() would, but
+        // keep start() from consuming the restored RNG stream.
+        PythonicRNG rng = game_.rng();
+        for (auto& ai : ais_) {
+            ai->start();
+        }
+        game_.rng() = rng;
+        if (restored_ai_state_) {
+            for (std::size_t i = 0; i < ais_.size(); ++i) {
+                ais_[i]->load_state((*restored_ai_state_)[i]);
+            }
+        }
+        restored_ai_state_.reset();
+        restored_ = false;
+    } else if (!paused_) {
+        throw std::logic_error("resume() needs a paused game, a checkpoint or a position");
+    }
+    return play_main_phase();
+}
+
+std::string GameDriver::play_main_phase() {
+    in_main_phase_ = true;
+    paused_ = false;
+    std::size_t seats = turn_order_.size();
+    std::size_t& main_turns = main_turns_;
+    active_seats_.clear();
+    for (std::size_t seat = 0; seat < seats; ++seat) {
+        if (player_alive(game_.players[turn_order_[seat]])) {
+            active_seats_.push_back(seat);
+        }
+    }
+    auto started = std::chrono::steady_clock::now();
     while (alive_players() > 1) {
-        if (player_alive(current_player())) {
-            auto& player = current_player();
-            auto& ai = current_ai();
-            handle_reinforcements(player, ai);
-            handle_attacks(player, ai);
-            handle_freemove(player, ai);
+        skip_eliminated();
+        if (limits_reached(main_turns)) {
+            break;
+        }
+        if (limits_.max_wall.count() != 0 &&
+            std::chrono::steady_clock::now() - started >= limits_.max_wall) {
+            throw std::runtime_error("game exceeded its wall-clock limit of " +
+                                     std::to_string(limits_.max_wall.count()) + " ms after " +
+                                     std::to_string(main_turns) + " turns");
+        }
+        if (statistics_ != nullptr && main_turns % seats == 0) {
+            statistics_->sample_round(game_, seat_of_player_, main_turns / seats);
+        }
+        TraceSpan span(trace_, "turn", "turn", "turn", static_cast<std::int64_t>(main_turns));
+        play_turn(current_player(), current_ai(), main_turns / seats);
+        advance_turn();
+        ++main_turns;
+        if (turn_hook_ && !turn_hook_(*this)) {
+            paused_ = true;
+            return {};
         }
-        ++turn_;
     }
+    in_main_phase_ = false;
 
+    bool adjudicated = alive_players() > 1;
     Player* winner = nullptr;
-    for (auto& player : game_.players) {
-        if (player_alive(player)) {
-            winner = &player;
-            break;
+    if (adjudicated) {
+        winner = adjudicate();
+    } else {
+        for (auto& player : game_.players) {
+            if (player_alive(player)) {
+                winner = &player;
+                break;
+            }
         }
     }
 
-    if (winner) {
+    if (statistics_ != nullptr) {
+        std::optional<std::size_t> winner_seat;
+        if (winner) {
+            winner_seat = seat_of_player_[seat_of(*winner)];
+        }
+        statistics_->record_game(winner_seat, main_turns, (main_turns + seats - 1) / seats,
+                                 first_conquest_round_, adjudicated);
+    }
+    result_ = {winner ? winner->name : std::string(), adjudicated, main_turns};
+    if (winner && adjudicated) {
+        game_.adjudicate(winner->name, static_cast<int>(main_turns));
+    } else if (winner) {
         game_.victory(winner->name);
     }
     for (auto& ai : ais_) {
@@ -257,45 +876,92 @@ std::string GameDriver::play() {
     return winner ? winner->name : std::string();
 }
 
-void GameDriver::initial_deal(std::vector<Territory*>& empty,
-                              std::unordered_map<std::string, int>& remaining) {
+// Moves the turn on to the next surviving player. The skipped seats still
+// count as turns, as they did when every seat was visited, so turn limits
+// and round sampling come out the same.
+void GameDriver::skip_eliminated() {
+    std::size_t seats = turn_order_.size();
+    std::size_t seat = turn_ % seats;
+    if (player_alive(game_.players[turn_order_[seat]])) {
+        return;
+    }
+    std::size_t next = seat;
+    while (true) {
+        auto it = std::upper_bound(active_seats_.begin(), active_seats_.end(), next);
+        if (it == active_seats_.end()) {
+            it = active_seats_.begin();
+        }
+        next = *it;
+        if (player_alive(game_.players[turn_order_[next]])) {
+            break;
+        }
+        active_seats_.erase(it);
+    }
+
+    std::size_t skipped = (next + seats - seat) % seats;
+    if (limits_.max_turns != 0) {
+        skipped = std::min(skipped, limits_.max_turns - std::min(limits_.max_turns, main_turns_));
+    }
+    if (statistics_ != nullptr) {
+        // At most one round boundary lies among fewer than `seats` turns.
+        std::size_t boundary = (main_turns_ + seats - 1) / seats * seats;
+        if (boundary < main_turns_ + skipped) {
+            statistics_->sample_round(game_, seat_of_player_, boundary / seats);
+        }
+    }
+    advance_turn(skipped);
+    main_turns_ += skipped;
+}
+
+void GameDriver::initial_deal(std::vector<Territory*>& empty, std::vector<int>& remaining) {
     game_.rng().shuffle(empty.begin(), empty.end());
     while (!empty.empty()) {
         auto* territory = empty.back();
         empty.pop_back();
         auto& player = current_player();
-        game_.claim(player.name, territory->name, 1);
-        remaining[player.name] -= 1;
-        ++turn_;
+        game_.claim_at(player, *territory, 1);
+        remaining[seat_of(player)] -= 1;
+        advance_turn();
     }
 }
 
-void GameDriver::finish_initial_reinforcements(std::unordered_map<std::string, int>& remaining) {
-    while (remaining_total(remaining) > 0) {
+void GameDriver::finish_initial_reinforcements(std::vector<int>& remaining) {
+    int total = std::accumulate(remaining.begin(), remaining.end(), 0);
+    while (total > 0) {
         auto& player = current_player();
-        if (remaining[player.name] > 0) {
-            auto* choice = current_ai().initial_placement({}, remaining[player.name]);
+        if (remaining[seat_of(player)] > 0) {
+            auto& ai = current_ai();
+            int left = remaining[seat_of(player)];
+            auto* choice = decide(
+                player, "AI::initial_placement", [&]() { return ai.initial_placement({}, left); },
+                [&]() -> Territory* {
+                    auto owned = owned_territories(player);
+                    return owned.empty() ? nullptr : owned.front();
+                });
             if (choice != nullptr && choice->owner == &player) {
-                game_.reinforce(player.name, choice->name, 1);
-                remaining[player.name] -= 1;
+                game_.reinforce_at(player, *choice, 1);
+                remaining[seat_of(player)] -= 1;
+                --total;
             }
         }
-        ++turn_;
+        advance_turn();
     }
 }
 
 void GameDriver::initial_placement() {
+    TraceSpan span(trace_, "phase", "initial_placement");
     std::vector<Territory*> empty;
     empty.reserve(game_.world.territories.size());
     for (auto& [_, territory] : game_.world.territories) {
         empty.push_back(territory.get());
     }
 
-    int available = 35 - 2 * static_cast<int>(game_.players.size());
-    std::unordered_map<std::string, int> remaining;
-    for (auto& player : game_.players) {
-        remaining[player.name] = available;
+    std::size_t players = game_.players.size();
+    int available = starting_armies_(players, empty.size());
+    if (players > 0 && static_cast<std::size_t>(available) * players < empty.size()) {
+        throw std::invalid_argument("too few starting armies to claim every territory");
     }
+    std::vector<int> remaining(players, available);
 
     if (deal_) {
         initial_deal(empty, remaining);
@@ -303,68 +969,133 @@ void GameDriver::initial_placement() {
         while (!empty.empty()) {
             auto& player = current_player();
             auto& ai = current_ai();
-            auto* choice = ai.initial_placement(empty, remaining[player.name]);
+            int left = remaining[seat_of(player)];
+            auto* choice = decide(
+                player, "AI::initial_placement",
+                [&]() { return ai.initial_placement(empty, left); },
+                [&]() { return empty.front(); });
             if (choice != nullptr &&
                 std::find(empty.begin(), empty.end(), choice) != empty.end()) {
-                game_.claim(player.name, choice->name, 1);
-                remaining[player.name] -= 1;
+                game_.claim_at(player, *choice, 1);
+                remaining[seat_of(player)] -= 1;
                 empty.erase(std::remove(empty.begin(), empty.end(), choice), empty.end());
             }
-            ++turn_;
+            advance_turn();
         }
     }
 
     finish_initial_reinforcements(remaining);
 }
 
+void GameDriver::play_turn(Player& player, AI& ai, std::size_t round) {
+    bool python = game_.rng().mode() == PythonicRNG::Mode::PythonMT;
+    switch (game_.emission()) {
+        case Emission::None:
+            return python ? play_turn_as<DriverPolicy<Emission::None, PythonicRNG::Mode::PythonMT>>(
+                                player, ai, round)
+                          : play_turn_as<DriverPolicy<Emission::None, PythonicRNG::Mode::StdMT>>(
+                                player, ai, round);
+        case Emission::Typed:
+            return python ? play_turn_as<DriverPolicy<Emission::Typed, PythonicRNG::Mode::PythonMT>>(
+                                player, ai, round)
+                          : play_turn_as<DriverPolicy<Emission::Typed, PythonicRNG::Mode::StdMT>>(
+                                player, ai, round);
+        case Emission::Legacy:
+            return python ? play_turn_as<DriverPolicy<Emission::Legacy, PythonicRNG::Mode::PythonMT>>(
+                                player, ai, round)
+                          : play_turn_as<DriverPolicy<Emission::Legacy, PythonicRNG::Mode::StdMT>>(
+                                player, ai, round);
+    }
+}
+
+template <typename Policy>
+void GameDriver::play_turn_as(Player& player, AI& ai, std::size_t round) {
+    handle_reinforcements<Policy>(player, ai);
+    handle_attacks<Policy>(player, ai, round);
+    handle_freemove<Policy>(player, ai);
+}
+
+template <typename Policy>
 void GameDriver::handle_reinforcements(Player& player, AI& ai) {
+    TraceSpan span(trace_, "phase", "handle_reinforcements");
     int reinforcements = game_.reinforcement_count(player);
-    auto allocations = ai.reinforce(reinforcements);
+    auto allocations = decide(
+        player, "AI::reinforce", [&]() { return ai.reinforce(reinforcements); },
+        []() { return std::unordered_map<Territory*, int>{}; });
     int assigned = 0;
     std::vector<std::pair<Territory*, int>> ordered(allocations.begin(), allocations.end());
     std::sort(ordered.begin(), ordered.end(),
-              [](const auto& lhs, const auto& rhs) { return lhs.first->name < rhs.first->name; });
+              [](const auto& lhs, const auto& rhs) { return by_name(lhs.first, rhs.first); });
     for (const auto& [territory, count] : ordered) {
         if (territory == nullptr || territory->owner != &player || count <= 0) {
             continue;
         }
-        game_.reinforce(player.name, territory->name, count);
+        game_.reinforce_at<Policy>(player, *territory, count);
         assigned += count;
     }
 
     if (assigned < reinforcements) {
         auto owned = owned_territories(player);
         if (!owned.empty()) {
-            game_.reinforce(player.name, owned.front()->name, reinforcements - assigned);
+            game_.reinforce_at<Policy>(player, *owned.front(), reinforcements - assigned);
         }
     }
 }
 
-void GameDriver::handle_attacks(Player& player, AI& ai) {
-    for (const auto& plan : ai.attack()) {
-        if (!plan.src || !plan.dst) {
-            continue;
-        }
-        if (plan.src->owner != &player || plan.dst->owner == &player) {
-            continue;
-        }
-        if (plan.src->connect.count(plan.dst) == 0) {
-            continue;
+template <typename Policy>
+void GameDriver::handle_attacks(Player& player, AI& ai, std::size_t round) {
+    TraceSpan span(trace_, "phase", "handle_attacks");
+    auto plans = decide(player, "AI::attack", [&]() { return ai.attack(); },
+                        []() { return std::vector<AttackPlan>{}; });
+    for (const auto& plan : plans) {
+        execute_attack<Policy>(player, plan, round);
+    }
+    while (true) {
+        auto plan = decide(player, "AI::next_attack", [&]() { return ai.next_attack(); },
+                           []() { return std::optional<AttackPlan>{}; });
+        if (!plan.has_value()) {
+            break;
         }
-        game_.resolve_combat(plan.src->name, plan.dst->name, plan.attack_strategy,
-                             plan.move_strategy);
+        execute_attack<Policy>(player, plan.value(), round);
+    }
+}
+
+template <typename Policy>
+void GameDriver::execute_attack(Player& player, const AttackPlan& plan, std::size_t round) {
+    if (!plan.src || !plan.dst) {
+        return;
+    }
+    if (plan.src->owner != &player || plan.dst->owner == &player) {
+        return;
+    }
+    if (plan.src->connect.count(plan.dst) == 0) {
+        return;
+    }
+    bool conquered;
+    {
+        TraceSpan span(trace_, "battle", "resolve_combat", "defender",
+                       static_cast<std::int64_t>(plan.dst->index));
+        conquered = game_.combat_at<Policy>(*plan.src, *plan.dst, plan.attack_strategy,
+                                            plan.move_strategy);
+    }
+    if (conquered && !first_conquest_round_.has_value()) {
+        first_conquest_round_ = round;
     }
 }
 
+template <typename Policy>
 void GameDriver::handle_freemove(Player& player, AI& ai) {
-    auto move_order = ai.freemove();
+    TraceSpan span(trace_, "phase", "handle_freemove");
+    auto move_order =
+        decide(player, "AI::freemove", [&]() { return ai.freemove(); },
+               []() { return std::optional<MoveOrder>{}; });
     if (!move_order.has_value()) {
         return;
     }
     const auto& [src, dst, count] = move_order.value();
     if (src != nullptr && dst != nullptr && src->owner == &player && dst->owner == &player &&
-        count >= 0) {
-        game_.move(player.name, src->name, dst->name, count);
+        game_.validate_move(*src, *dst, count)) {
+        game_.move_at<Policy>(player, *src, *dst, count);
     }
 }
 
@@ -372,10 +1103,7 @@ bool GameDriver::player_alive(const Player& player) const {
     return game_.territory_count(player) > 0;
 }
 
-int GameDriver::alive_players() const {
-    return std::count_if(game_.players.begin(), game_.players.end(),
-                         [&](const Player& player) { return player_alive(player); });
-}
+int GameDriver::alive_players() const { return game_.alive_players(); }
 
 std::vector<Territory*> GameDriver::owned_territories(const Player& player) const {
     std::vector<Territory*> owned;
@@ -1,16 +1,25 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <iosfwd>
 #include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "adjudication.hpp"
+#include "decision.hpp"
 #include "game.hpp"
+#include "packed_state.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 
 namespace pyrisk {
 
+class GameStatistics;
+
 using AttackStrategy = std::function<bool(int, int)>;
 using MoveStrategy = std::function<int(int)>;
 
@@ -27,6 +36,13 @@ struct MoveOrder {
     int count;
 };
 
+// Odds of a battle fought to the end (see AI::battle_odds).
+struct BattleOdds {
+    double victory{0.0};
+    double attackers{0.0};  // mean surviving attackers when the attack wins
+    double defenders{0.0};  // mean surviving defenders when it fails
+};
+
 class AI {
 public:
     AI(Player& player, Game& game);
@@ -34,21 +50,59 @@ public:
 
     virtual void start() {}
     virtual void end() {}
+    // Called by GameDriver::reset() before the AI plays another game on the
+    // same board, ahead of that game's start(). AIs that carry state across
+    // games beyond what start() rebuilds clear it here.
+    virtual void reset() {}
     virtual void on_event(const Event& /*event*/) {}
+    // Events passed to on_event(); AIs that override on_event() must list
+    // the kinds they need here.
+    virtual EventMask subscribed_events() const { return kNoEvents; }
 
     virtual Territory* initial_placement(const std::vector<Territory*>& empty, int remaining) = 0;
     virtual std::unordered_map<Territory*, int> reinforce(int available) = 0;
     virtual std::vector<AttackPlan> attack() = 0;
+    // Called after the plans from attack() have been resolved, and again
+    // after each plan it returns is resolved, until it returns nullopt. AIs
+    // ported from Python generators use it to see the board between attacks.
+    virtual std::optional<AttackPlan> next_attack() { return std::nullopt; }
     virtual std::optional<MoveOrder> freemove() { return std::nullopt; }
 
+    // Checkpoint support. AIs whose play depends on more than the board and
+    // the game's RNG return that state here; when a checkpoint is resumed,
+    // load_state() is called on a fresh AI after start().
+    virtual std::string save_state() const { return {}; }
+    virtual void load_state(const std::string& /*state*/) {}
+
+    // Exact odds of `n_atk` attackers against `n_def` defenders, i.e. the
+    // limit of the Monte Carlo AI.simulate() in the Python AIs. Cached
+    // process-wide and independent of the game's RNG. Past 500 armies in
+    // all, a normal approximation stands in for the exact grid.
+    static BattleOdds battle_odds(int n_atk, int n_def);
+
+    void set_decision_context(DecisionContext* context) { decision_ = context; }
+
 protected:
     std::vector<Territory*> owned_territories() const;
     std::vector<Territory*> owned_territories(const Player& player) const;
+    // Owned territories bordering another player's, in territory_list order,
+    // and the enemy forces next to a territory; both maintained by Game.
+    const std::vector<Territory*>& frontier() const { return game_.frontier(player_); }
+    int enemy_forces(const Territory& territory) const {
+        return game_.adjacent_enemy_forces(territory);
+    }
+
+    // Charges search work against the current decision budget. Returns true
+    // once the AI should stop thinking and answer with what it has.
+    bool charge_nodes(std::uint64_t nodes = 1);
 
     Player& player_;
     Game& game_;
     World& world_;
     PythonicRNG& rng_;
+
+private:
+    DecisionContext* decision_{nullptr};
 };
 
 class StupidAI : public AI {
@@ -60,9 +114,24 @@ public:
     std::vector<AttackPlan> attack() override;
 };
 
+// DeterministicAI's thresholds; the defaults are the original constants.
+// Attacks go from a frontier territory when forces > attack_ratio *
+// defenders + attack_margin, continue while attackers > defenders +
+// continue_margin, and move min(remaining - 1, move_cap) after a conquest.
+// Reinforcements are spread over the reinforce_spread most threatened
+// territories, or over all of them when zero.
+struct DeterministicParams {
+    double attack_ratio{1.0};
+    double attack_margin{1.0};
+    double continue_margin{0.0};
+    int move_cap{3};
+    std::size_t reinforce_spread{0};
+};
+
 class DeterministicAI : public AI {
 public:
-    using AI::AI;
+    DeterministicAI(Player& player, Game& game, DeterministicParams params = {})
+        : AI(player, game), params_(params) {}
 
     Territory* initial_placement(const std::vector<Territory*>& empty, int remaining) override;
     std::unordered_map<Territory*, int> reinforce(int available) override;
@@ -70,8 +139,16 @@ public:
     std::optional<MoveOrder> freemove() override { return std::nullopt; }
 
 private:
-    std::vector<Territory*> sorted_owned() const;
+    std::vector<Territory*> sorted_frontier() const;
     std::vector<Territory*> reinforce_targets() const;
+
+    DeterministicParams params_;
+};
+
+struct GameResult {
+    std::string winner;
+    bool adjudicated{false};  // limits ran out and the scorer picked `winner`
+    std::size_t turns{0};
 };
 
 class GameDriver {
@@ -85,20 +162,112 @@ public:
     Game& game();
     const Game& game() const;
 
+    // Runs AI decisions on `pool` (when given) under `budget`. With a pool, a
+    // decision still running when its wall-clock budget expires is cancelled
+    // and replaced by a default; an answer the driver already has is kept,
+    // however late, and counted in DecisionStats::over_budget. Cancelling is
+    // cooperative: the AI reads the live board, so the game waits until it
+    // notices through charge_nodes() and returns. The built-in AIs poll it
+    // in their loops; an AI that never does still holds up its game.
+    void set_decision_budget(DecisionBudget budget, ThreadPool* pool = nullptr);
+    const std::vector<DecisionStats>& decision_stats() const;
+
+    // Restricts the external logger to `events`. With kNoEvents and no AI
+    // subscriptions the game runs in results-only mode and builds no events.
+    void set_logger_events(EventMask events);
+
+    // Records turns, phases, battles and AI calls as spans into `trace`
+    // (nullptr turns tracing off); it must outlive the driver's games.
+    void set_trace(TraceRecorder* trace);
+
+    // Feeds per-round holdings and the final result of play() into
+    // `statistics`, which must outlive the call.
+    void set_statistics(GameStatistics* statistics);
+
+    // Stops play() once `limits` are exhausted and awards the game to the
+    // surviving player with the highest score.
+    void set_limits(GameLimits limits, Scorer scorer = score_territories);
+    const GameResult& result() const;
+
+    // How many armies each player gets for initial placement.
+    void set_starting_armies(StartingArmies rule);
+
+    // Turn counter and seat order, for PackedState.
+    TurnState turn_state() const { return {turn_, turn_order_}; }
+
+    // Called after every main-phase turn a surviving player takes; the
+    // seats of eliminated players are skipped without a call. Returning
+    // false pauses play() or resume(), which then return an empty string
+    // with paused() set.
+    using TurnHook = std::function<bool(GameDriver&)>;
+    void set_turn_hook(TurnHook hook);
+    bool paused() const { return paused_; }
+
     std::string play();
 
+    // Gets the driver ready to play() another game from `seed` on the same
+    // world, players and AIs: the board is emptied, the RNG reseeded, the
+    // seat order, result and decision stats cleared and every AI's reset()
+    // called. Limits, loggers, hooks and budgets are kept. Allocates
+    // nothing, so a worker can play any number of games on one driver; the
+    // game itself plays exactly as it would on a new driver with that seed.
+    void reset(std::uint32_t seed);
+
+    // Checkpoints can be saved between main-phase turns: from the turn hook
+    // or while paused. They hold the board, turn counter, seat order, RNG
+    // state and, optionally, each AI's save_state(); limits, loggers and
+    // statistics are configuration and are not saved. Load into a driver
+    // built with the same map, player names and AIs, then call resume().
+    void save_checkpoint(std::ostream& out, bool with_ai_state = true) const;
+    void load_checkpoint(std::istream& in);
+    // Continues a paused game, or one loaded from a checkpoint.
+    std::string resume();
+
+    // Skips initial placement and sets up `position` (owners, forces, turn
+    // counter and seat order) as the start of the main phase; resume() then
+    // plays on from it. Turn limits count from the position. Throws
+    // std::runtime_error, leaving the game as it was, when the position does
+    // not fit this map and lobby.
+    void set_position(const PackedState& position);
+
 private:
+    // Runs one AI call under the decision budget, traced as `what` in
+    // category "ai", and falls back on a timeout.
+    template <typename Decide, typename Fallback>
+    auto decide(const Player& player, const char* what, Decide&& decide, Fallback&& fallback)
+        -> std::invoke_result_t<Decide&>;
+    std::size_t seat_of(const Player& player) const;
     void dispatch_event(const Event& event);
+    void update_subscriptions();
     Player& current_player();
     AI& current_ai();
+    void advance_turn(std::size_t turns = 1);
     void setup_turn_order();
+    void assign_seats();
+    void restore_board(const PackedState& position);
+    std::string play_main_phase();
+    void skip_eliminated();
     void initial_placement();
-    void initial_deal(std::vector<Territory*>& empty,
-                      std::unordered_map<std::string, int>& remaining);
-    void finish_initial_reinforcements(std::unordered_map<std::string, int>& remaining);
+    void initial_deal(std::vector<Territory*>& empty, std::vector<int>& remaining);
+    void finish_initial_reinforcements(std::vector<int>& remaining);
+    // Plays one main-phase turn with the board actions specialized for the
+    // game's emission level and RNG mode. The driver checks every AI
+    // decision itself, so the game's own checks are compiled out.
+    void play_turn(Player& player, AI& ai, std::size_t round);
+    template <Emission E, PythonicRNG::Mode R>
+    using DriverPolicy = GamePolicy<Validation::Unchecked, E, R>;
+    template <typename Policy>
+    void play_turn_as(Player& player, AI& ai, std::size_t round);
+    template <typename Policy>
     void handle_reinforcements(Player& player, AI& ai);
-    void handle_attacks(Player& player, AI& ai);
+    template <typename Policy>
+    void handle_attacks(Player& player, AI& ai, std::size_t round);
+    template <typename Policy>
+    void execute_attack(Player& player, const AttackPlan& plan, std::size_t round);
+    template <typename Policy>
     void handle_freemove(Player& player, AI& ai);
+    bool limits_reached(std::size_t main_turns) const;
+    Player* adjudicate();
     bool player_alive(const Player& player) const;
     int alive_players() const;
     std::vector<Territory*> owned_territories(const Player& player) const;
@@ -108,7 +277,31 @@ private:
     std::vector<std::size_t> turn_order_;
     std::size_t turn_{0};
     bool deal_{false};
+    std::vector<std::size_t> seat_of_player_;
+    // Seats whose players were alive when last looked at, in seat order;
+    // eliminated players are dropped as the turn passes them.
+    std::vector<std::size_t> active_seats_;
+    GameStatistics* statistics_{nullptr};
+    std::optional<std::size_t> first_conquest_round_;
+    std::size_t main_turns_{0};
+    bool in_main_phase_{false};
+    bool paused_{false};
+    TurnHook turn_hook_{};
+    // AI states from load_checkpoint(), handed over by resume().
+    std::optional<std::vector<std::string>> restored_ai_state_;
+    bool restored_{false};
+    GameLimits limits_{};
+    StartingArmies starting_armies_{classic_starting_armies};
+    Scorer scorer_{score_territories};
+    GameResult result_{};
     EventLogger external_logger_{};
+    EventMask logger_events_{kAllEvents};
+    std::vector<EventMask> ai_events_;
+    DecisionBudget budget_{};
+    ThreadPool* pool_{nullptr};
+    TraceRecorder* trace_{nullptr};
+    DecisionContext decision_context_{};
+    std::vector<DecisionStats> decision_stats_;
 };
 
 }  // namespace pyrisk
@@ -0,0 +1,46 @@
+#include "ai_registry.hpp"
+
+#include <memory>
+#include <utility>
+
+#include "al_ai.hpp"
+#include "better_ai.hpp"
+#include "chron_ai.hpp"
+
+namespace pyrisk {
+namespace {
+
+template <typename T>
+GameDriver::AiFactory factory() {
+    return [](Player& p, Game& g) { return std::make_unique<T>(p, g); };
+}
+
+const std::vector<std::pair<std::string, GameDriver::AiFactory>>& registry() {
+    static const std::vector<std::pair<std::string, GameDriver::AiFactory>> entries = {
+        {"StupidAI", factory<StupidAI>()},   {"DeterministicAI", factory<DeterministicAI>()},
+        {"ChronAI", factory<ChronAI>()},     {"AlAI", factory<AlAI>()},
+        {"BetterAI", factory<BetterAI>()},
+    };
+    return entries;
+}
+
+}  // namespace
+
+std::optional<GameDriver::AiFactory> find_ai(const std::string& name) {
+    for (const auto& [entry_name, make] : registry()) {
+        if (entry_name == name) {
+            return make;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::string> ai_names() {
+    std::vector<std::string> names;
+    for (const auto& entry : registry()) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "ai.hpp"
+
+namespace pyrisk {
+
+// Factories for the built-in AIs by class name, as given to pyrisk.py.
+std::optional<GameDriver::AiFactory> find_ai(const std::string& name);
+std::vector<std::string> ai_names();
+
+}  // namespace pyrisk
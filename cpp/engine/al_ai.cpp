@@ -0,0 +1,159 @@
+#include "al_ai.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <utility>
+
+namespace pyrisk {
+namespace {
+
+const std::array<std::string, 6> kAreaPriority = {"Australia", "South America", "North America",
+                                                  "Africa",    "Europe",        "Asia"};
+
+}  // namespace
+
+std::size_t AlAI::area_rank(const Area* area) const {
+    auto it = std::find(kAreaPriority.begin(), kAreaPriority.end(), area->name);
+    return static_cast<std::size_t>(it - kAreaPriority.begin());
+}
+
+std::vector<Territory*> AlAI::priority() const {
+    auto owned = owned_territories();
+    for (const auto& name : kAreaPriority) {
+        std::vector<Territory*> borders;
+        for (auto* territory : owned) {
+            if (territory->area->name == name && territory->border()) {
+                borders.push_back(territory);
+            }
+        }
+        if (!borders.empty()) {
+            return borders;
+        }
+    }
+    // The Python version runs off the end of the list here; fall back to
+    // anything we own.
+    return owned;
+}
+
+Territory* AlAI::initial_placement(const std::vector<Territory*>& empty, int /*remaining*/) {
+    if (empty.empty()) {
+        auto candidates = priority();
+        if (candidates.empty()) {
+            return nullptr;
+        }
+        return candidates[static_cast<std::size_t>(rng_.randbelow(static_cast<int>(candidates.size())))];
+    }
+
+    // Finish off any area we are one territory short of.
+    std::vector<std::pair<Area*, std::size_t>> owned_by_area;
+    for (auto* territory : owned_territories()) {
+        auto it = std::find_if(owned_by_area.begin(), owned_by_area.end(),
+                               [&](const auto& entry) { return entry.first == territory->area; });
+        if (it == owned_by_area.end()) {
+            owned_by_area.emplace_back(territory->area, 1);
+        } else {
+            ++it->second;
+        }
+    }
+    for (const auto& [area, count] : owned_by_area) {
+        if (count + 1 != area->territories.size()) {
+            continue;
+        }
+        std::vector<Territory*> remain;
+        for (auto* territory : empty) {
+            if (territory->area == area) {
+                remain.push_back(territory);
+            }
+        }
+        if (!remain.empty()) {
+            return remain[static_cast<std::size_t>(rng_.randbelow(static_cast<int>(remain.size())))];
+        }
+    }
+    return *std::min_element(empty.begin(), empty.end(), [&](const Territory* a, const Territory* b) {
+        return area_rank(a->area) < area_rank(b->area);
+    });
+}
+
+std::unordered_map<Territory*, int> AlAI::reinforce(int available) {
+    std::unordered_map<Territory*, int> result;
+    auto candidates = priority();
+    if (candidates.empty()) {
+        return result;
+    }
+    int each = available / static_cast<int>(candidates.size());
+    for (auto* territory : candidates) {
+        result[territory] = each;
+    }
+    result[candidates.front()] += available - each * static_cast<int>(candidates.size());
+    return result;
+}
+
+std::vector<AttackPlan> AlAI::attack() {
+    can_attack_ = false;
+    next_territory_ = 0;
+    source_ = nullptr;
+    return {};
+}
+
+std::optional<AttackPlan> AlAI::next_attack() {
+    const auto& territories = world_.territory_list;
+    while (true) {
+        if (source_ == nullptr) {
+            while (next_territory_ < territories.size()) {
+                Territory* territory = territories[next_territory_++];
+                if (territory->owner == &player_ && territory->forces > 1) {
+                    source_ = territory;
+                    next_target_ = territory->neighbours(Side::Hostile).begin();
+                    break;
+                }
+            }
+            if (source_ == nullptr) {
+                // Keep sweeping the board until a full pass attacks nothing.
+                if (!can_attack_) {
+                    return std::nullopt;
+                }
+                can_attack_ = false;
+                next_territory_ = 0;
+                continue;
+            }
+        }
+
+        while (next_target_ != source_->neighbours(Side::Hostile).end()) {
+            Territory* target = *next_target_++;
+            if (target->forces - 5 >= source_->forces) {
+                continue;
+            }
+            // Each sweep can cost an exact odds table per target.
+            if (charge_nodes()) {
+                return std::nullopt;
+            }
+            BattleOdds odds = battle_odds(source_->forces, target->forces);
+            int opt = rng_.randint(0, 49);
+            if (odds.victory * 100 > 30 + opt &&
+                odds.attackers > static_cast<double>(source_->forces) / (opt + 1)) {
+                can_attack_ = true;
+                return AttackPlan{source_, target, {}, {}};
+            }
+        }
+        source_ = nullptr;
+    }
+}
+
+std::optional<MoveOrder> AlAI::freemove() {
+    for (auto* territory : owned_territories()) {
+        for (auto* enemy : territory->neighbours(Side::Hostile)) {
+            if (enemy->forces <= territory->forces) {
+                continue;
+            }
+            for (auto* friendly : territory->neighbours(Side::Friendly)) {
+                if (friendly->forces > 1) {
+                    return MoveOrder{friendly, territory, friendly->forces - 1};
+                }
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "ai.hpp"
+
+namespace pyrisk {
+
+// Port of ai/al.py: like BetterAI, but with a fixed continent priority and
+// attacks chosen from simulated battle odds.
+class AlAI : public AI {
+public:
+    using AI::AI;
+
+    Territory* initial_placement(const std::vector<Territory*>& empty, int remaining) override;
+    std::unordered_map<Territory*, int> reinforce(int available) override;
+    std::vector<AttackPlan> attack() override;
+    std::optional<AttackPlan> next_attack() override;
+    std::optional<MoveOrder> freemove() override;
+
+private:
+    std::size_t area_rank(const Area* area) const;
+    std::vector<Territory*> priority() const;
+
+    // attack() generator state.
+    bool can_attack_{false};
+    std::size_t next_territory_{0};
+    Territory* source_{nullptr};
+    NeighbourView::iterator next_target_;
+};
+
+}  // namespace pyrisk
@@ -0,0 +1,116 @@
+#include "analysis.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <tuple>
+
+namespace pyrisk {
+
+std::pair<double, double> wilson_interval(std::size_t wins, std::size_t trials, double z) {
+    if (trials == 0) {
+        return {0.0, 1.0};
+    }
+    double n = static_cast<double>(trials);
+    double p = static_cast<double>(wins) / n;
+    double z2 = z * z;
+    double centre = (p + z2 / (2 * n)) / (1 + z2 / n);
+    double spread = z * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+    return {std::max(0.0, centre - spread), std::min(1.0, centre + spread)};
+}
+
+PositionAnalyzer::PositionAnalyzer(std::unordered_map<std::string, AreaDefinition> areas,
+                                   std::string connections, std::vector<std::string> player_names,
+                                   std::vector<GameDriver::AiFactory> factories, ThreadPool* pool)
+    : areas_(std::move(areas)),
+      connections_(std::move(connections)),
+      names_(std::move(player_names)),
+      factories_(std::move(factories)),
+      pool_(pool) {}
+
+PositionAnalyzer::Playout PositionAnalyzer::playout(const PackedState& position, std::uint32_t seed,
+                                                    GameLimits limits) const {
+    World world;
+    world.load(areas_, connections_);
+    GameDriver driver(std::move(world), names_, factories_, /*deal=*/false, {}, seed);
+    driver.set_logger_events(kNoEvents);
+    driver.set_limits(limits);
+    driver.set_position(position);
+    driver.resume();
+    const auto& result = driver.result();
+    return {result.winner, result.adjudicated, result.turns};
+}
+
+AnalysisResult PositionAnalyzer::analyze(const PackedState& position,
+                                         const AnalysisConfig& config) const {
+    AnalysisResult result;
+    std::vector<std::size_t> wins(names_.size(), 0);
+    std::size_t turns = 0;
+    std::size_t batch = std::max<std::size_t>(1, config.batch);
+
+    auto tally = [&](const Playout& outcome) {
+        ++result.playouts;
+        turns += outcome.turns;
+        if (outcome.adjudicated) {
+            ++result.adjudicated;
+        }
+        auto it = std::find(names_.begin(), names_.end(), outcome.winner);
+        if (it == names_.end()) {
+            ++result.undecided;
+        } else {
+            ++wins[static_cast<std::size_t>(it - names_.begin())];
+        }
+    };
+    auto narrow_enough = [&]() {
+        for (std::size_t won : wins) {
+            auto [low, high] = wilson_interval(won, result.playouts, config.z);
+            if (high - low >= config.target_width) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::size_t next = 0;
+    while (next < config.max_playouts) {
+        std::size_t end = std::min(config.max_playouts, next + batch);
+        if (pool_ == nullptr) {
+            for (std::size_t i = next; i < end; ++i) {
+                tally(playout(position, config.seed + static_cast<std::uint32_t>(i), config.limits));
+            }
+        } else {
+            std::vector<std::future<Playout>> pending;
+            pending.reserve(end - next);
+            for (std::size_t i = next; i < end; ++i) {
+                auto seed = config.seed + static_cast<std::uint32_t>(i);
+                pending.push_back(pool_->submit(
+                    [this, &position, seed, &config]() { return playout(position, seed, config.limits); }));
+            }
+            for (auto& future : pending) {
+                tally(future.get());
+            }
+        }
+        next = end;
+        if (config.target_width > 0.0 && next < config.max_playouts && narrow_enough()) {
+            result.stopped_early = true;
+            break;
+        }
+    }
+
+    for (std::size_t i = 0; i < names_.size(); ++i) {
+        WinEstimate estimate;
+        estimate.player = names_[i];
+        estimate.wins = wins[i];
+        if (result.playouts > 0) {
+            estimate.rate = static_cast<double>(wins[i]) / static_cast<double>(result.playouts);
+        }
+        std::tie(estimate.low, estimate.high) = wilson_interval(wins[i], result.playouts, config.z);
+        result.players.push_back(estimate);
+    }
+    if (result.playouts > 0) {
+        result.mean_turns = static_cast<double>(turns) / static_cast<double>(result.playouts);
+    }
+    return result;
+}
+
+}  // namespace pyrisk
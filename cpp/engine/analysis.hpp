@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ai.hpp"
+#include "thread_pool.hpp"
+
+namespace pyrisk {
+
+struct AnalysisConfig {
+    std::size_t max_playouts{1000};
+    std::size_t batch{64};       // playouts between early-stopping checks
+    double z{1.96};              // normal quantile of the intervals; 1.96 is 95%
+    double target_width{0.0};    // stop once every interval is narrower; 0 plays them all
+    std::uint32_t seed{0};       // playout i is seeded with seed + i
+    GameLimits limits{};         // per playout, counted from the position
+};
+
+struct WinEstimate {
+    std::string player;
+    std::size_t wins{0};
+    double rate{0.0};
+    double low{0.0};
+    double high{0.0};
+};
+
+struct AnalysisResult {
+    std::vector<WinEstimate> players;  // by Game::players index
+    std::size_t playouts{0};
+    std::size_t adjudicated{0};
+    std::size_t undecided{0};          // playouts nobody won
+    double mean_turns{0.0};            // main-phase turns played from the position
+    bool stopped_early{false};
+};
+
+// Wilson score interval for `wins` out of `trials` at normal quantile `z`.
+std::pair<double, double> wilson_interval(std::size_t wins, std::size_t trials, double z);
+
+// Estimates each player's chance of winning from a mid-game position by
+// playing it out many times with different seeds. Playouts run in batches
+// on `pool` (or on the calling thread without one) and early stopping is
+// only checked between batches, so with AIs that replay exactly from their
+// seed the result does not depend on the pool size.
+class PositionAnalyzer {
+public:
+    PositionAnalyzer(std::unordered_map<std::string, AreaDefinition> areas, std::string connections,
+                     std::vector<std::string> player_names,
+                     std::vector<GameDriver::AiFactory> factories, ThreadPool* pool = nullptr);
+
+    // `position` holds owners, forces, seat order and, through its turn
+    // counter, the player to move; see PackedState and GameDriver::set_position().
+    AnalysisResult analyze(const PackedState& position, const AnalysisConfig& config) const;
+
+private:
+    struct Playout {
+        std::string winner;
+        bool adjudicated{false};
+        std::size_t turns{0};
+    };
+
+    Playout playout(const PackedState& position, std::uint32_t seed, GameLimits limits) const;
+
+    std::unordered_map<std::string, AreaDefinition> areas_;
+    std::string connections_;
+    std::vector<std::string> names_;
+    std::vector<GameDriver::AiFactory> factories_;
+    ThreadPool* pool_;
+};
+
+}  // namespace pyrisk
@@ -0,0 +1,127 @@
+// Estimates win probabilities from a mid-game position by parallel
+// playouts. The position is a checkpoint file, or the board after
+// --pause-at turns of a game played with --seed.
+//
+//   pyrisk_analysis --checkpoint game.ckpt --playouts 2000 --width 0.05
+//   pyrisk_analysis --seed 7 --pause-at 30 --players BetterAI,ChronAI --threads 4
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ai_registry.hpp"
+#include "analysis.hpp"
+#include "world_data.hpp"
+
+int main(int argc, char** argv) {
+    using namespace pyrisk;
+
+    const char* checkpoint_path = nullptr;
+    std::uint32_t seed = 42;
+    std::size_t pause_at = 30;
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string players = "DeterministicAI,StupidAI";
+    AnalysisConfig config;
+    config.limits.max_turns = 1000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--checkpoint") == 0) {
+            checkpoint_path = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--pause-at") == 0) {
+            pause_at = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--players") == 0) {
+            players = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            threads = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--playouts") == 0) {
+            config.max_playouts = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--batch") == 0) {
+            config.batch = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--width") == 0) {
+            config.target_width = std::strtod(argv[i + 1], nullptr);
+        } else if (std::strcmp(argv[i], "--z") == 0) {
+            config.z = std::strtod(argv[i + 1], nullptr);
+        } else if (std::strcmp(argv[i], "--playout-seed") == 0) {
+            config.seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--max-turns") == 0) {
+            config.limits.max_turns = std::strtoul(argv[i + 1], nullptr, 10);
+        } else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> names;
+    std::vector<GameDriver::AiFactory> factories;
+    for (std::size_t start = 0; start <= players.size();) {
+        std::size_t end = std::min(players.find(',', start), players.size());
+        std::string ai = players.substr(start, end - start);
+        start = end + 1;
+        auto factory = find_ai(ai);
+        if (!factory) {
+            std::cerr << "unknown AI " << ai << std::endl;
+            return 1;
+        }
+        names.push_back("P" + std::to_string(names.size() + 1));
+        factories.push_back(*factory);
+    }
+
+    try {
+        World world;
+        world.load(kAreas, kConnectionData);
+        GameDriver driver(std::move(world), names, factories, /*deal=*/false, {}, seed);
+        if (checkpoint_path != nullptr) {
+            std::ifstream in(checkpoint_path, std::ios::binary);
+            if (!in) {
+                std::cerr << "cannot open " << checkpoint_path << std::endl;
+                return 1;
+            }
+            driver.load_checkpoint(in);
+        } else {
+            auto played = std::make_shared<std::size_t>(0);
+            driver.set_turn_hook([played, pause_at](GameDriver&) { return ++*played < pause_at; });
+            std::string winner = driver.play();
+            if (!driver.paused()) {
+                std::cout << "game ended before the pause point; winner: " << winner << std::endl;
+                return 0;
+            }
+        }
+        PackedState position(driver.game(), driver.turn_state());
+        const Player* to_move = driver.game().to_move();
+
+        ThreadPool pool(threads);
+        PositionAnalyzer analyzer(kAreas, kConnectionData, names, factories,
+                                  threads > 1 ? &pool : nullptr);
+        auto started = std::chrono::steady_clock::now();
+        AnalysisResult result = analyzer.analyze(position, config);
+        double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        std::cout << "to move: " << (to_move ? to_move->name : std::string("-"))
+                  << "  playouts: " << result.playouts
+                  << (result.stopped_early ? " (stopped early)" : "") << "  mean turns: "
+                  << std::fixed << std::setprecision(1) << result.mean_turns
+                  << "  adjudicated: " << result.adjudicated << "  undecided: " << result.undecided
+                  << "  seconds: " << std::setprecision(2) << seconds << std::endl;
+        for (std::size_t i = 0; i < result.players.size(); ++i) {
+            const auto& estimate = result.players[i];
+            std::cout << estimate.player
+                      << " territories=" << driver.game().territory_count(driver.game().players[i])
+                      << " wins=" << estimate.wins << " rate="
+                      << std::setprecision(3) << estimate.rate << " [" << estimate.low << ", "
+                      << estimate.high << "]" << std::endl;
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,310 @@
+#include "async_logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace pyrisk {
+namespace {
+
+std::atomic<std::uint64_t> next_logger_id{1};
+
+std::size_t round_up_pow2(std::size_t n) {
+    std::size_t out = 1;
+    while (out < n) {
+        out <<= 1;
+    }
+    return out;
+}
+
+}  // namespace
+
+bool EventRecord::pack(const Event& event) {
+    if (event.args.size() > kMaxArgs || event.name.size() > kTextCapacity) {
+        return false;
+    }
+    kind = event.kind;
+    std::size_t used = event.name.size();
+    std::memcpy(text, event.name.data(), used);
+    name_length = static_cast<std::uint16_t>(used);
+    argc = static_cast<std::uint8_t>(event.args.size());
+
+    for (std::size_t i = 0; i < event.args.size(); ++i) {
+        bool fits = std::visit(
+            [&](const auto& value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, std::string>) {
+                    if (value.size() > kTextCapacity - used) {
+                        return false;
+                    }
+                    std::memcpy(text + used, value.data(), value.size());
+                    types[i] = ArgType::String;
+                    values[i][0] = static_cast<std::int32_t>(used);
+                    values[i][1] = static_cast<std::int32_t>(value.size());
+                    used += value.size();
+                } else if constexpr (std::is_same_v<T, int>) {
+                    types[i] = ArgType::Int;
+                    values[i][0] = value;
+                } else if constexpr (std::is_same_v<T, std::pair<int, int>>) {
+                    types[i] = ArgType::Pair;
+                    values[i][0] = value.first;
+                    values[i][1] = value.second;
+                }
+                return true;
+            },
+            event.args[i]);
+        if (!fits) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EventRecord::unpack(Event& out) const {
+    out.kind = kind;
+    out.name.assign(text, name_length);
+    out.args.resize(argc);
+    for (std::size_t i = 0; i < argc; ++i) {
+        switch (types[i]) {
+            case ArgType::String: {
+                auto* str = std::get_if<std::string>(&out.args[i]);
+                if (str == nullptr) {
+                    out.args[i] = std::string();
+                    str = std::get_if<std::string>(&out.args[i]);
+                }
+                str->assign(text + values[i][0], static_cast<std::size_t>(values[i][1]));
+                break;
+            }
+            case ArgType::Int:
+                out.args[i] = values[i][0];
+                break;
+            case ArgType::Pair:
+                out.args[i] = std::make_pair(values[i][0], values[i][1]);
+                break;
+        }
+    }
+}
+
+EventRing::EventRing(std::size_t capacity)
+    : slots_(round_up_pow2(std::max<std::size_t>(capacity, 2))), mask_(slots_.size() - 1) {}
+
+bool EventRing::try_push(const EventRecord& record) {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+        return false;
+    }
+    slots_[tail & mask_] = record;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool EventRing::try_pop(EventRecord& record) {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    record = slots_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+AsyncLogger::AsyncLogger(int fd, AsyncLoggerOptions options)
+    : id_(next_logger_id.fetch_add(1)), options_(options), sink_(fd, options.block_size) {
+    consumer_ = std::thread([this]() { consume_loop(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+    stopping_.store(true);
+    flushed_cv_.notify_all();
+    consumer_.join();
+}
+
+EventLogger AsyncLogger::logger() {
+    return [this](const Event& event) { log(event); };
+}
+
+AsyncLogger::Channel& AsyncLogger::local_channel() {
+    // Channels of loggers that have since been destroyed are only referenced
+    // from here, so they are pruned on the next lookup.
+    thread_local std::vector<std::pair<std::uint64_t, std::shared_ptr<Channel>>> local;
+    for (auto& [id, channel] : local) {
+        if (id == id_) {
+            return *channel;
+        }
+    }
+    local.erase(std::remove_if(local.begin(), local.end(),
+                               [](const auto& entry) { return entry.second.use_count() == 1; }),
+                local.end());
+
+    auto channel = std::make_shared<Channel>(options_.ring_capacity);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channels_.push_back(channel);
+    }
+    local.emplace_back(id_, channel);
+    return *channel;
+}
+
+void AsyncLogger::log(const Event& event) {
+    Channel& channel = local_channel();
+    if (failed_.load(std::memory_order_acquire)) {
+        channel.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    EventRecord record;
+    if (!record.pack(event)) {
+        // Its record in the ring only marks the place; the consumer takes
+        // the event itself from the queue, so the record must not be dropped.
+        oversized_.fetch_add(1, std::memory_order_relaxed);
+        record = EventRecord{};
+        record.kind = event.kind;
+        record.spilled = true;
+        std::lock_guard<std::mutex> lock(channel.overflow_mutex);
+        channel.overflow.push_back(event);
+    }
+    bool game_over = event.kind == EventKind::Victory || event.kind == EventKind::Adjudicated;
+    push(channel, record, game_over || record.spilled);
+    if (game_over) {
+        std::uint64_t target = channel.pushed.load(std::memory_order_relaxed);
+        channel.flush_target.store(target, std::memory_order_release);
+        wait_flushed(channel, target);
+    }
+}
+
+void AsyncLogger::push(Channel& channel, const EventRecord& record, bool must_deliver) {
+    bool block = must_deliver || options_.backpressure == AsyncLoggerOptions::Backpressure::Block;
+    while (!channel.ring.try_push(record)) {
+        // Nothing drains the ring once the writer has failed.
+        if (!block || failed_.load(std::memory_order_acquire)) {
+            channel.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+    channel.pushed.fetch_add(1, std::memory_order_release);
+}
+
+void AsyncLogger::wait_flushed(Channel& channel, std::uint64_t target) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    flushed_cv_.wait(lock, [&]() {
+        return channel.flushed.load(std::memory_order_acquire) >= target || error_;
+    });
+}
+
+void AsyncLogger::flush() {
+    std::uint64_t request = flush_requested_.fetch_add(1) + 1;
+    std::unique_lock<std::mutex> lock(mutex_);
+    flushed_cv_.wait(lock, [&]() { return flush_done_ >= request || error_; });
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+std::uint64_t AsyncLogger::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint64_t total = 0;
+    for (const auto& channel : channels_) {
+        total += channel->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::uint64_t AsyncLogger::oversized() const { return oversized_.load(std::memory_order_relaxed); }
+
+bool AsyncLogger::drain(std::vector<std::shared_ptr<Channel>>& channels, Event& scratch) {
+    constexpr std::size_t kBatch = 256;
+    bool any = false;
+    EventRecord record;
+    for (auto& channel : channels) {
+        std::size_t popped = 0;
+        while (popped < kBatch && channel->ring.try_pop(record)) {
+            if (record.spilled) {
+                std::lock_guard<std::mutex> lock(channel->overflow_mutex);
+                scratch = std::move(channel->overflow.front());
+                channel->overflow.pop_front();
+            } else {
+                record.unpack(scratch);
+            }
+            sink_.write(scratch);
+            ++popped;
+        }
+        if (popped > 0) {
+            channel->consumed.fetch_add(popped, std::memory_order_release);
+            any = true;
+        }
+    }
+    return any;
+}
+
+void AsyncLogger::consume_loop() {
+    try {
+        write_loop();
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+        }
+        failed_.store(true, std::memory_order_release);
+        flushed_cv_.notify_all();
+    }
+}
+
+void AsyncLogger::write_loop() {
+    std::vector<std::shared_ptr<Channel>> channels;
+    Event scratch;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            channels = channels_;
+        }
+        std::uint64_t requested = flush_requested_.load();
+        bool any = drain(channels, scratch);
+
+        bool victory_pending = std::any_of(channels.begin(), channels.end(), [](const auto& c) {
+            auto target = c->flush_target.load(std::memory_order_acquire);
+            return target > c->flushed.load(std::memory_order_relaxed) &&
+                   c->consumed.load(std::memory_order_relaxed) >= target;
+        });
+        bool flush_pending = !any && requested > flush_done_;
+        if (victory_pending || flush_pending) {
+            sink_.flush();
+            for (auto& channel : channels) {
+                channel->flushed.store(channel->consumed.load(std::memory_order_relaxed),
+                                       std::memory_order_release);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (flush_pending) {
+                    flush_done_ = requested;
+                }
+            }
+            flushed_cv_.notify_all();
+        }
+
+        if (!any) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                // Retire rings whose producing thread has exited.
+                channels_.erase(
+                    std::remove_if(channels_.begin(), channels_.end(),
+                                   [](const auto& c) {
+                                       return c.use_count() == 2 &&
+                                              c->consumed.load() == c->pushed.load() &&
+                                              c->dropped.load() == 0;
+                                   }),
+                    channels_.end());
+            }
+            if (stopping_.load()) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            flushed_cv_.wait_for(lock, std::chrono::microseconds(200));
+        }
+    }
+    sink_.flush();
+}
+
+}  // namespace pyrisk
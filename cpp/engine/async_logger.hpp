@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "game.hpp"
+#include "jsonl_sink.hpp"
+
+namespace pyrisk {
+
+// Fixed-size copy of an Event that can be passed between threads without
+// allocating. Strings, including the event name, live in `text`.
+struct EventRecord {
+    static constexpr std::size_t kMaxArgs = 6;
+    static constexpr std::size_t kTextCapacity = 192;
+
+    enum class ArgType : std::uint8_t { String, Int, Pair };
+
+    bool pack(const Event& event);
+    void unpack(Event& out) const;
+
+    EventKind kind{EventKind::Start};
+    // The event did not fit and waits in its channel's overflow queue.
+    bool spilled{false};
+    std::uint8_t argc{0};
+    std::uint16_t name_length{0};
+    ArgType types[kMaxArgs]{};
+    // Strings store (offset, length) into `text`; ints use the first slot.
+    std::int32_t values[kMaxArgs][2]{};
+    char text[kTextCapacity];
+};
+
+// Bounded single-producer/single-consumer queue of EventRecords.
+class EventRing {
+public:
+    explicit EventRing(std::size_t capacity);
+
+    bool try_push(const EventRecord& record);
+    bool try_pop(EventRecord& record);
+
+private:
+    std::vector<EventRecord> slots_;
+    std::size_t mask_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+struct AsyncLoggerOptions {
+    enum class Backpressure { Block, Drop };
+
+    Backpressure backpressure{Backpressure::Block};
+    std::size_t ring_capacity{4096};
+    std::size_t block_size{JsonlSink::kDefaultBlock};
+};
+
+// Moves JSONL formatting and I/O off the game threads. Each thread that logs
+// gets its own ring, which a background thread drains into a JsonlSink.
+// Game-ending events ("victory", "adjudicated") are never dropped and do not
+// return until they, and everything their thread logged before them, have
+// been written to the fd. Events too big for an EventRecord take a slower,
+// allocating path but keep their place. A write error stops the background thread; events
+// logged after it are dropped and flush() rethrows it.
+class AsyncLogger {
+public:
+    explicit AsyncLogger(int fd, AsyncLoggerOptions options = {});
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // The returned logger may be shared by any number of game threads; it
+    // must not outlive this AsyncLogger.
+    EventLogger logger();
+    void log(const Event& event);
+
+    // Blocks until everything logged so far has been written. Throws the
+    // error that stopped the writer, if any.
+    void flush();
+
+    std::uint64_t dropped() const;
+    // Events that took the overflow path.
+    std::uint64_t oversized() const;
+
+private:
+    struct Channel {
+        explicit Channel(std::size_t capacity) : ring(capacity) {}
+
+        EventRing ring;
+        std::atomic<std::uint64_t> pushed{0};
+        std::atomic<std::uint64_t> consumed{0};
+        std::atomic<std::uint64_t> flush_target{0};
+        std::atomic<std::uint64_t> flushed{0};
+        std::atomic<std::uint64_t> dropped{0};
+        // Spilled events, in the order of their records in the ring.
+        std::mutex overflow_mutex;
+        std::deque<Event> overflow;
+    };
+
+    Channel& local_channel();
+    void push(Channel& channel, const EventRecord& record, bool must_deliver);
+    void wait_flushed(Channel& channel, std::uint64_t target);
+    void consume_loop();
+    void write_loop();
+    bool drain(std::vector<std::shared_ptr<Channel>>& channels, Event& scratch);
+
+    const std::uint64_t id_;
+    AsyncLoggerOptions options_;
+    JsonlSink sink_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable flushed_cv_;
+    std::vector<std::shared_ptr<Channel>> channels_;
+    std::atomic<std::uint64_t> oversized_{0};
+    std::atomic<std::uint64_t> flush_requested_{0};
+    std::uint64_t flush_done_{0};
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;  // guarded by mutex_
+    std::thread consumer_;
+};
+
+}  // namespace pyrisk
@@ -0,0 +1,150 @@
+#include "better_ai.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "binary_io.hpp"
+
+namespace pyrisk {
+
+void BetterAI::start() {
+    std::vector<std::size_t> order(world_.area_list.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    rng_.shuffle(order.begin(), order.end());
+    area_rank_.assign(order.size(), 0);
+    for (std::size_t rank = 0; rank < order.size(); ++rank) {
+        area_rank_[order[rank]] = rank;
+    }
+}
+
+std::string BetterAI::save_state() const {
+    std::ostringstream out;
+    write_varint(out, area_rank_.size());
+    for (auto rank : area_rank_) {
+        write_varint(out, rank);
+    }
+    return out.str();
+}
+
+void BetterAI::load_state(const std::string& state) {
+    std::istringstream in(state);
+    std::vector<std::size_t> ranks(static_cast<std::size_t>(read_varint(in)));
+    if (ranks.size() != world_.area_list.size()) {
+        throw std::runtime_error("BetterAI state is for a different map");
+    }
+    for (auto& rank : ranks) {
+        rank = static_cast<std::size_t>(read_varint(in));
+    }
+    area_rank_ = std::move(ranks);
+}
+
+std::vector<Territory*> BetterAI::priority() const {
+    std::vector<Territory*> borders;
+    for (auto* territory : owned_territories()) {
+        if (territory->border()) {
+            borders.push_back(territory);
+        }
+    }
+    if (borders.empty()) {
+        return owned_territories();
+    }
+    std::stable_sort(borders.begin(), borders.end(), [&](const Territory* a, const Territory* b) {
+        return area_rank_[a->area->index] < area_rank_[b->area->index];
+    });
+    const Area* first = borders.front()->area;
+    borders.erase(std::remove_if(borders.begin(), borders.end(),
+                                 [&](const Territory* t) { return t->area != first; }),
+                  borders.end());
+    return borders;
+}
+
+Territory* BetterAI::initial_placement(const std::vector<Territory*>& empty, int /*remaining*/) {
+    if (!empty.empty()) {
+        return *std::min_element(empty.begin(), empty.end(), [&](const Territory* a, const Territory* b) {
+            return area_rank_[a->area->index] < area_rank_[b->area->index];
+        });
+    }
+    auto candidates = priority();
+    if (candidates.empty()) {
+        return nullptr;
+    }
+    return candidates[static_cast<std::size_t>(rng_.randbelow(static_cast<int>(candidates.size())))];
+}
+
+std::unordered_map<Territory*, int> BetterAI::reinforce(int available) {
+    std::unordered_map<Territory*, int> result;
+    auto candidates = priority();
+    if (candidates.empty()) {
+        return result;
+    }
+    for (; available > 0 && !charge_nodes(); --available) {
+        ++result[candidates[static_cast<std::size_t>(rng_.randbelow(static_cast<int>(candidates.size())))]];
+    }
+    return result;
+}
+
+std::vector<AttackPlan> BetterAI::attack() {
+    next_territory_ = 0;
+    source_ = nullptr;
+    return {};
+}
+
+std::optional<AttackPlan> BetterAI::next_attack() {
+    while (true) {
+        if (source_ != nullptr && next_target_ < targets_.size()) {
+            Territory* target = targets_[next_target_++];
+            if (targets_.size() == 1) {
+                return AttackPlan{source_, target, [](int a, int d) { return a > d; }, {}};
+            }
+            int margin = total_ - target->forces + 3;
+            return AttackPlan{source_, target, [margin](int a, int d) { return a > d + margin; },
+                              [](int) { return 1; }};
+        }
+
+        // Neighbours are chosen when the territory is reached, after the
+        // attacks from earlier territories have been resolved.
+        source_ = nullptr;
+        const auto& territories = world_.territory_list;
+        while (source_ == nullptr && next_territory_ < territories.size()) {
+            if (charge_nodes()) {
+                return std::nullopt;
+            }
+            Territory* territory = territories[next_territory_++];
+            if (territory->owner != &player_ || territory->forces <= 1) {
+                continue;
+            }
+            targets_.clear();
+            total_ = 0;
+            for (auto* adj : territory->neighbours(Side::Hostile)) {
+                if (territory->forces >= adj->forces + 3) {
+                    targets_.push_back(adj);
+                    total_ += adj->forces;
+                }
+            }
+            source_ = territory;
+            next_target_ = 0;
+        }
+        if (source_ == nullptr) {
+            return std::nullopt;
+        }
+    }
+}
+
+std::optional<MoveOrder> BetterAI::freemove() {
+    Territory* src = nullptr;
+    for (auto* territory : owned_territories()) {
+        if (!territory->border() && (src == nullptr || territory->forces >= src->forces)) {
+            src = territory;
+        }
+    }
+    if (src == nullptr) {
+        return std::nullopt;
+    }
+    return MoveOrder{src, priority().front(), src->forces - 1};
+}
+
+}  // namespace pyrisk
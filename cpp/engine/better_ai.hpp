@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ai.hpp"
+
+namespace pyrisk {
+
+// Port of ai/better.py: picks a priority continent at random and concentrates
+// on holding and reinforcing it.
+class BetterAI : public AI {
+public:
+    using AI::AI;
+
+    void start() override;
+    std::string save_state() const override;
+    void load_state(const std::string& state) override;
+    Territory* initial_placement(const std::vector<Territory*>& empty, int remaining) override;
+    std::unordered_map<Territory*, int> reinforce(int available) override;
+    std::vector<AttackPlan> attack() override;
+    std::optional<AttackPlan> next_attack() override;
+    std::optional<MoveOrder> freemove() override;
+
+private:
+    std::vector<Territory*> priority() const;
+
+    std::vector<std::size_t> area_rank_;  // by Area::index
+
+    // attack() generator state.
+    std::size_t next_territory_{0};
+    Territory* source_{nullptr};
+    std::vector<Territory*> targets_;
+    std::size_t next_target_{0};
+    int total_{0};
+};
+
+}  // namespace pyrisk
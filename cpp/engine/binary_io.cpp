@@ -0,0 +1,62 @@
+#include "binary_io.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace pyrisk {
+
+void write_varint(std::ostream& out, std::uint64_t value) {
+    char bytes[10];
+    std::size_t n = 0;
+    do {
+        auto byte = static_cast<unsigned char>(value & 0x7F);
+        value >>= 7;
+        if (value != 0) {
+            byte |= 0x80;
+        }
+        bytes[n++] = static_cast<char>(byte);
+    } while (value != 0);
+    out.write(bytes, static_cast<std::streamsize>(n));
+}
+
+std::uint64_t read_varint(std::istream& in) {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == std::char_traits<char>::eof()) {
+            throw std::runtime_error("truncated binary stream");
+        }
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("malformed varint in binary stream");
+}
+
+void write_string(std::ostream& out, const std::string& value) {
+    write_varint(out, value.size());
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+std::string read_string(std::istream& in) {
+    std::string value;
+    std::uint64_t size = read_varint(in);
+    // Grow with the data actually read, so a corrupt length cannot force a
+    // huge allocation up front.
+    char chunk[4096];
+    while (size > 0) {
+        auto want = static_cast<std::streamsize>(std::min<std::uint64_t>(size, sizeof(chunk)));
+        in.read(chunk, want);
+        if (in.gcount() != want) {
+            throw std::runtime_error("truncated binary stream");
+        }
+        value.append(chunk, static_cast<std::size_t>(want));
+        size -= static_cast<std::uint64_t>(want);
+    }
+    return value;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace pyrisk {
+
+// LEB128 varints and length-prefixed strings shared by the binary file
+// formats. Readers throw std::runtime_error on truncated or malformed input.
+void write_varint(std::ostream& out, std::uint64_t value);
+std::uint64_t read_varint(std::istream& in);
+void write_string(std::ostream& out, const std::string& value);
+std::string read_string(std::istream& in);
+
+}  // namespace pyrisk
@@ -0,0 +1,202 @@
+// Pauses a game and saves a checkpoint, resumes one, or checks that a game
+// resumed from a checkpoint in a fresh driver plays out exactly like the
+// uninterrupted game. Games are capped at --max-turns (default 1000), as in
+// tournaments.
+//
+// --verify compares event logs, so it only accepts AIs that replay exactly
+// from their seed. The others iterate containers keyed by pointer, and two
+// runs of one seed drift apart with or without a checkpoint.
+//
+//   pyrisk_checkpoint --save game.ckpt --seed 7 --pause-at 40
+//   pyrisk_checkpoint --resume game.ckpt
+//   pyrisk_checkpoint --verify 50 --pause-at 40
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ai_registry.hpp"
+#include "jsonl_sink.hpp"
+#include "world_data.hpp"
+
+namespace {
+
+using namespace pyrisk;
+
+struct Lineup {
+    std::vector<std::string> names;
+    std::vector<GameDriver::AiFactory> factories;
+};
+
+// AIs whose games replay exactly from the seed.
+bool replays_exactly(const std::string& ai) { return ai == "DeterministicAI"; }
+
+std::unique_ptr<GameDriver> make_driver(const Lineup& lineup, std::uint32_t seed,
+                                        GameLimits limits, EventLogger logger = {}) {
+    World world;
+    world.load(kAreas, kConnectionData);
+    auto driver = std::make_unique<GameDriver>(std::move(world), lineup.names, lineup.factories,
+                                               /*deal=*/false, std::move(logger), seed);
+    driver->set_limits(limits);
+    return driver;
+}
+
+// Returns false once `turns` main-phase turns have been played.
+GameDriver::TurnHook pause_after(std::size_t turns) {
+    auto played = std::make_shared<std::size_t>(0);
+    return [played, turns](GameDriver&) { return ++*played < turns; };
+}
+
+enum class Verdict { Matched, Short, EndedEarly, Diverged };
+
+// Plays `seed` through, and again with a pause after `pause_at` turns, a
+// checkpoint and a resume in a new driver; both must log the same events.
+Verdict verify_seed(const Lineup& lineup, std::uint32_t seed, std::size_t pause_at,
+                    GameLimits limits) {
+    JsonlWriter full;
+    std::size_t split = 0;
+    std::size_t played = 0;
+    auto reference =
+        make_driver(lineup, seed, limits, [&](const Event& event) { full.append(event); });
+    reference->set_turn_hook([&](GameDriver&) {
+        if (++played == pause_at) {
+            split = full.size();
+        }
+        return true;
+    });
+    std::string winner = reference->play();
+    if (played < pause_at) {
+        return Verdict::Short;
+    }
+
+    std::stringstream checkpoint;
+    auto first = make_driver(lineup, seed, limits);
+    first->set_turn_hook(pause_after(pause_at));
+    first->play();
+    if (!first->paused()) {
+        // The replay did not follow the reference even before the pause.
+        return Verdict::EndedEarly;
+    }
+    first->save_checkpoint(checkpoint);
+
+    JsonlWriter resumed;
+    auto second =
+        make_driver(lineup, seed + 1, limits, [&](const Event& event) { resumed.append(event); });
+    second->load_checkpoint(checkpoint);
+    std::string resumed_winner = second->resume();
+    bool same = resumed_winner == winner && resumed.str() == full.str().substr(split);
+    return same ? Verdict::Matched : Verdict::Diverged;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* save_path = nullptr;
+    const char* resume_path = nullptr;
+    std::size_t verify_games = 0;
+    std::uint32_t seed = 42;
+    std::size_t pause_at = 50;
+    GameLimits limits{1000, 0};
+    std::string players = "DeterministicAI,DeterministicAI";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--save") == 0) {
+            save_path = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--resume") == 0) {
+            resume_path = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--verify") == 0) {
+            verify_games = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--pause-at") == 0) {
+            pause_at = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--max-turns") == 0) {
+            limits.max_turns = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--players") == 0) {
+            players = argv[i + 1];
+        } else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    Lineup lineup;
+    for (std::size_t start = 0; start <= players.size();) {
+        std::size_t end = std::min(players.find(',', start), players.size());
+        std::string ai = players.substr(start, end - start);
+        start = end + 1;
+        auto factory = find_ai(ai);
+        if (!factory) {
+            std::cerr << "unknown AI " << ai << std::endl;
+            return 1;
+        }
+        if (verify_games > 0 && !replays_exactly(ai)) {
+            std::cerr << ai << " does not replay exactly from its seed, so --verify cannot check it"
+                      << std::endl;
+            return 1;
+        }
+        lineup.names.push_back("P" + std::to_string(lineup.names.size() + 1));
+        lineup.factories.push_back(*factory);
+    }
+
+    try {
+        if (verify_games > 0) {
+            std::size_t failed = 0;
+            std::size_t short_games = 0;
+            for (std::uint32_t s = 0; s < verify_games; ++s) {
+                switch (verify_seed(lineup, s, pause_at, limits)) {
+                    case Verdict::Matched:
+                        break;
+                    case Verdict::Short:
+                        ++short_games;
+                        break;
+                    case Verdict::EndedEarly:
+                        std::cerr << "seed " << s << ": replay ended before the pause point"
+                                  << std::endl;
+                        ++failed;
+                        break;
+                    case Verdict::Diverged:
+                        std::cerr << "seed " << s << ": resumed game diverged" << std::endl;
+                        ++failed;
+                        break;
+                }
+            }
+            std::cout << "verified " << verify_games - failed << "/" << verify_games << " games ("
+                      << short_games << " over before the pause point)" << std::endl;
+            return failed == 0 ? 0 : 1;
+        }
+        if (save_path != nullptr) {
+            auto driver = make_driver(lineup, seed, limits);
+            driver->set_turn_hook(pause_after(pause_at));
+            std::string winner = driver->play();
+            if (!driver->paused()) {
+                std::cout << "game ended before the pause point; winner: " << winner << std::endl;
+                return 0;
+            }
+            std::ofstream out(save_path, std::ios::binary);
+            driver->save_checkpoint(out);
+            std::cout << "saved after " << pause_at << " turns to " << save_path << std::endl;
+            return 0;
+        }
+        if (resume_path != nullptr) {
+            std::ifstream in(resume_path, std::ios::binary);
+            if (!in) {
+                std::cerr << "cannot open " << resume_path << std::endl;
+                return 1;
+            }
+            auto driver = make_driver(lineup, seed, limits);
+            driver->load_checkpoint(in);
+            std::cout << "Winner: " << driver->resume() << std::endl;
+            return 0;
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    std::cerr << "one of --save, --resume or --verify is required" << std::endl;
+    return 1;
+}
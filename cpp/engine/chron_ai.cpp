@@ -0,0 +1,734 @@
+#include "chron_ai.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+#include "binary_io.hpp"
+
+namespace pyrisk {
+namespace {
+
+// Strategy tables, indexed by ChronAI::Priority.
+constexpr std::array<double, 8> kNoArea = {0.0, 0.0, 0.0, 0.25, 0.0, 0.0, 0.50, 0.50};
+constexpr std::array<double, 8> kStrongest = {0.80, 0.65, 0.50, 0.65, 0.65, 0.80, 0.80, 0.80};
+constexpr std::array<double, 8> kWeakest = {0.50, 0.0, 0.0, 0.50, 0.70, 0.50, 0.50, 0.50};
+constexpr std::array<double, 8> kIntermediate = {0.70, 0.50, 0.0, 0.60, 0.60, 0.60, 0.60, 0.60};
+
+template <typename T>
+T& pick(PythonicRNG& rng, std::vector<T>& items) {
+    return items[static_cast<std::size_t>(rng.randbelow(static_cast<int>(items.size())))];
+}
+
+// Insertion-ordered allocation, so random draws over its keys are stable.
+struct Allocation {
+    int& operator[](Territory* territory) {
+        for (auto& entry : entries) {
+            if (entry.first == territory) {
+                return entry.second;
+            }
+        }
+        entries.emplace_back(territory, 0);
+        return entries.back().second;
+    }
+
+    int total() const {
+        int sum = 0;
+        for (const auto& entry : entries) {
+            sum += entry.second;
+        }
+        return sum;
+    }
+
+    std::vector<std::pair<Territory*, int>> entries;
+};
+
+}  // namespace
+
+int ChronAI::player_forces(const Player& player) const {
+    int forces = 0;
+    for (auto* territory : world_.territory_list) {
+        if (territory->owner == &player) {
+            forces += territory->forces;
+        }
+    }
+    return forces;
+}
+
+bool ChronAI::owns_area(const Player& player) const {
+    return std::any_of(world_.area_list.begin(), world_.area_list.end(),
+                       [&](const Area* area) { return area->owner() == &player; });
+}
+
+std::size_t ChronAI::area_rank(const Area* area) const {
+    return static_cast<std::size_t>(
+        std::find(area_priority_.begin(), area_priority_.end(), area) - area_priority_.begin());
+}
+
+void ChronAI::start() {
+    const auto& territories = world_.territory_list;
+    set_seed(territories[static_cast<std::size_t>(rng_.randbelow(static_cast<int>(territories.size())))]);
+    plans_.clear();
+    priority_.fill(0.0);
+}
+
+// Everything else ChronAI keeps is rebuilt at the start of each turn.
+std::string ChronAI::save_state() const {
+    std::ostringstream out;
+    write_varint(out, seed_->index);
+    return out.str();
+}
+
+void ChronAI::load_state(const std::string& state) {
+    std::istringstream in(state);
+    auto index = read_varint(in);
+    if (index >= world_.territory_list.size()) {
+        throw std::runtime_error("ChronAI state is for a different map");
+    }
+    set_seed(world_.territory_list[static_cast<std::size_t>(index)]);
+}
+
+void ChronAI::set_seed(Territory* seed) {
+    seed_ = seed;
+
+    // Areas closest (in hops) to our seed territory come first.
+    std::vector<double> area_distance(world_.area_list.size(), 0.0);
+    for (auto* area : world_.area_list) {
+        double total = 0.0;
+        for (auto* territory : area->territories) {
+            // Path length in territories, as len(pathfind(...)) in Python.
+            total += static_cast<double>(world_.distance(*seed_, *territory) + 1);
+        }
+        area_distance[area->index] = total / static_cast<double>(area->territories.size());
+    }
+    area_priority_ = world_.area_list;
+    std::stable_sort(area_priority_.begin(), area_priority_.end(), [&](const Area* a, const Area* b) {
+        return area_distance[a->index] < area_distance[b->index];
+    });
+}
+
+Territory* ChronAI::initial_placement(const std::vector<Territory*>& empty, int /*remaining*/) {
+    if (empty.empty()) {
+        std::vector<Territory*> choice;
+        for (auto* territory : owned_territories()) {
+            choice.push_back(territory);
+            if (territory->area_border() && territory->border()) {
+                choice.push_back(territory);
+            }
+            if (territory->border()) {
+                choice.push_back(territory);
+            }
+            if (territory->area->owner() == &player_) {
+                choice.push_back(territory);
+            }
+        }
+        return choice.empty() ? nullptr : pick(rng_, choice);
+    }
+
+    // Size of the largest holding in each area, when it is not ours.
+    std::vector<int> enemy_count(world_.area_list.size(), 0);
+    for (auto* area : world_.area_list) {
+        std::vector<Player*> owners;
+        for (auto* territory : area->territories) {
+            if (territory->owner) {
+                owners.push_back(territory->owner);
+            }
+        }
+        Player* leader = nullptr;
+        long best = 0;
+        for (auto* owner : owners) {
+            long count = std::count(owners.begin(), owners.end(), owner);
+            if (count >= best) {
+                best = count;
+                leader = owner;
+            }
+        }
+        if (leader && leader != &player_) {
+            enemy_count[area->index] = static_cast<int>(best);
+        }
+    }
+
+    Territory* best = nullptr;
+    double best_score = 0.0;
+    for (auto* territory : empty) {
+        const Area* area = territory->area;
+        auto size = static_cast<int>(area->territories.size());
+        double score = static_cast<double>(area_priority_.size() - area_rank(area));
+        score += territory->area_border() ? 1 : 0;
+        score += territory->border() ? 1 : 0;
+        score += std::max(area->value - 2 * (size - enemy_count[area->index]), 0);
+        int ours = 0;
+        for (auto* other : area->territories) {
+            ours += other->owner == &player_ ? 1 : 0;
+        }
+        score += static_cast<double>(ours) / size;
+        if (best == nullptr || score >= best_score) {
+            best = territory;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+int ChronAI::needed_reinforcements(Territory* territory, double prob) {
+    std::vector<Player*> adjacent_players;
+    for (auto* adj : territory->neighbours(Side::Enemy)) {
+        if (std::find(adjacent_players.begin(), adjacent_players.end(), adj->owner) ==
+                adjacent_players.end()) {
+            adjacent_players.push_back(adj->owner);
+        }
+    }
+
+    // Every neighbour attacks, the strongest one topped up with its owner's
+    // reinforcements.
+    std::vector<int> worst_case;
+    for (auto* player : adjacent_players) {
+        std::size_t first = worst_case.size();
+        for (auto* adj : territory->neighbours(Side::Enemy)) {
+            if (adj->owner == player) {
+                worst_case.push_back(adj->forces);
+            }
+        }
+        auto strongest = std::max_element(worst_case.begin() + static_cast<long>(first), worst_case.end());
+        *strongest += game_.reinforcement_count(*player);
+    }
+
+    int defenders = needed_defenders(worst_case, territory->forces, prob);
+    return std::max(0, defenders - territory->forces);
+}
+
+int ChronAI::needed_defenders(const std::vector<int>& worst_case, int defenders, double prob) {
+    if (worst_case.empty()) {
+        return 0;
+    }
+    auto holds = [&](int count) {
+        charge_nodes(worst_case.size());
+        int survive = count;
+        for (int attackers : worst_case) {
+            BattleOdds odds = battle_odds(attackers, survive);
+            if (odds.victory > prob) {
+                return false;
+            }
+            survive = static_cast<int>(odds.defenders);
+        }
+        return survive > 0;
+    };
+    // The Python version counts up one army at a time; with exact odds
+    // holding is monotonic in the garrison, so bisect for the same answer.
+    int max_defenders = std::accumulate(worst_case.begin(), worst_case.end(), 0);
+    if (defenders > max_defenders || holds(defenders)) {
+        return defenders;
+    }
+    if (!holds(max_defenders)) {
+        return max_defenders + 1;
+    }
+    int lo = defenders;  // does not hold
+    int hi = max_defenders;
+    while (hi - lo > 1 && !charge_nodes(0)) {
+        int mid = lo + (hi - lo) / 2;
+        (holds(mid) ? hi : lo) = mid;
+    }
+    return hi;
+}
+
+std::optional<int> ChronAI::needed_attackers(const std::vector<int>& defenders, int attackers,
+                                            double prob, int survivors) {
+    if (defenders.empty()) {
+        return survivors;
+    }
+    auto succeeds = [&](int count) {
+        charge_nodes(defenders.size());
+        int a = count;
+        for (int d : defenders) {
+            BattleOdds odds = battle_odds(a, d);
+            if (odds.victory < prob) {
+                return false;
+            }
+            a = static_cast<int>(odds.attackers) - 1;
+        }
+        return a >= survivors;
+    };
+    // Gallop then bisect; success is monotonic in the number of attackers.
+    if (succeeds(attackers)) {
+        return attackers;
+    }
+    int lo = attackers;  // fails
+    int step = 1;
+    while (!succeeds(lo + step)) {
+        if (charge_nodes(0)) {
+            return std::nullopt;
+        }
+        lo += step;
+        step *= 2;
+    }
+    int hi = lo + step;
+    while (hi - lo > 1 && !charge_nodes(0)) {
+        int mid = lo + (hi - lo) / 2;
+        (succeeds(mid) ? hi : lo) = mid;
+    }
+    return hi;
+}
+
+void ChronAI::strategy() {
+    std::vector<const Player*> strength_order;
+    std::vector<int> strength(game_.players.size());
+    for (std::size_t i = 0; i < game_.players.size(); ++i) {
+        strength_order.push_back(&game_.players[i]);
+        strength[i] = player_forces(game_.players[i]) + game_.reinforcement_count(game_.players[i]);
+    }
+    auto strength_of = [&](const Player* p) {
+        return strength[static_cast<std::size_t>(p - game_.players.data())];
+    };
+    std::stable_sort(strength_order.begin(), strength_order.end(),
+                     [&](const Player* a, const Player* b) { return strength_of(a) < strength_of(b); });
+    const Player* strongest = strength_order.back();
+    const Player* weakest = strength_order.front();
+    bool have_area = owns_area(player_);
+
+    // Re-anchor on something we still hold.
+    if (seed_->owner != &player_) {
+        std::vector<Territory*> candidates;
+        for (auto* territory : owned_territories()) {
+            if (have_area ? territory->area->owner() == &player_
+                          : !territory->neighbours(Side::Friendly).empty()) {
+                candidates.push_back(territory);
+            }
+        }
+        if (candidates.empty()) {
+            candidates = owned_territories();
+        }
+        if (!candidates.empty()) {
+            seed_ = pick(rng_, candidates);
+        }
+    }
+
+    if (!have_area) {
+        priority_ = kNoArea;
+    } else if (&player_ == strongest) {
+        priority_ = kStrongest;
+    } else if (&player_ == weakest) {
+        priority_ = kWeakest;
+    } else {
+        priority_ = kIntermediate;
+    }
+}
+
+ChronAI::AttackEvaluation ChronAI::evaluate_attack(const std::vector<Territory*>& taken) const {
+    // Overlay the captures on the real board instead of copying the world.
+    std::vector<char> captured(world_.territory_list.size(), 0);
+    for (auto* territory : taken) {
+        captured[territory->index] = 1;
+    }
+    auto owner_after = [&](const Territory* t) -> const Player* {
+        return captured[t->index] ? &player_ : t->owner;
+    };
+    auto forces_after = [&](const Territory* t) { return captured[t->index] ? 1 : t->forces; };
+    auto border_after = [&](const Territory* t) {
+        return t->neighbours().any_of([&](const Territory* adj) {
+            return owner_after(adj) != nullptr && owner_after(adj) != owner_after(t);
+        });
+    };
+    auto reinforcements_after = [&](const Player& player) {
+        int count = 0;
+        for (auto* territory : world_.territory_list) {
+            count += owner_after(territory) == &player ? 1 : 0;
+        }
+        int bonus = 0;
+        for (auto* area : world_.area_list) {
+            bool all = std::all_of(area->territories.begin(), area->territories.end(),
+                                   [&](const Territory* t) { return owner_after(t) == &player; });
+            bonus += all ? area->value : 0;
+        }
+        return std::max(count / 3, 3) + bonus;
+    };
+
+    AttackEvaluation result;
+    result.taken = taken;
+    result.reinforcements = reinforcements_after(player_) - game_.reinforcement_count(player_);
+    for (const auto& player : game_.players) {
+        if (&player == &player_) {
+            continue;
+        }
+        // Players with no territories left only count on the "before" side,
+        // as in the Python version.
+        if (game_.territory_count(player) > 0) {
+            result.enemy_reinforcements += reinforcements_after(player);
+        }
+        result.enemy_reinforcements -= game_.reinforcement_count(player);
+    }
+
+    for (auto* territory : world_.territory_list) {
+        bool ours_before = territory->owner == &player_;
+        bool ours_after = owner_after(territory) == &player_;
+        bool border_before = ours_before && territory->border();
+        bool border_now = ours_after && border_after(territory);
+        if (border_now && !border_before) {
+            result.new_borders.push_back(territory);
+        } else if (border_before && !border_now) {
+            result.new_inland.push_back(territory);
+            result.freed_forces += territory->forces;
+        }
+        if (border_now) {
+            for (auto* adj : territory->neighbours()) {
+                if (owner_after(adj) != &player_) {
+                    result.border_hostiles += forces_after(adj);
+                }
+            }
+        }
+        if (border_before) {
+            result.border_hostiles -= territory->neighbours(Side::Hostile).forces();
+        }
+    }
+    for (auto* territory : taken) {
+        result.resistance += territory->forces;
+    }
+    return result;
+}
+
+std::optional<std::vector<ChronAI::Route>> ChronAI::random_walk(const std::vector<Territory*>& srcs,
+                                                                const std::vector<Territory*>& via,
+                                                                const Defenses& dests) {
+    std::vector<Route> routes;
+    for (auto* src : srcs) {
+        routes.push_back({src});
+    }
+    rng_.shuffle(routes.begin(), routes.end());
+
+    std::vector<char> open(world_.territory_list.size(), 0);
+    std::size_t remaining = 0;
+    for (auto* territory : via) {
+        if (!open[territory->index]) {
+            open[territory->index] = 1;
+            ++remaining;
+        }
+    }
+
+    std::vector<Territory*> possible;
+    bool found = true;
+    while (found) {
+        found = false;
+        for (auto& route : routes) {
+            possible.clear();
+            for (auto* next : route.back()->neighbours()) {
+                if (open[next->index]) {
+                    possible.push_back(next);
+                }
+            }
+            if (!possible.empty()) {
+                Territory* choice = pick(rng_, possible);
+                route.push_back(choice);
+                open[choice->index] = 0;
+                --remaining;
+                found = true;
+            }
+        }
+    }
+
+    bool reaches = std::any_of(routes.begin(), routes.end(), [&](const Route& route) {
+        return std::any_of(dests.begin(), dests.end(),
+                           [&](const auto& dest) { return dest.first == route.back(); });
+    });
+    if (remaining == 0 && reaches) {
+        return routes;
+    }
+    return std::nullopt;
+}
+
+std::optional<ChronAI::RoutePlan> ChronAI::plan_attack(const std::vector<Territory*>& srcs,
+                                                       const std::vector<Territory*>& targets,
+                                                       const Defenses& defenses, double prob,
+                                                       int tries) {
+    std::vector<std::vector<Route>> possible;
+    for (int i = 0; i < tries && possible.size() <= 10; ++i) {
+        if (auto routes = random_walk(srcs, targets, defenses)) {
+            possible.push_back(std::move(*routes));
+        }
+    }
+    if (possible.empty()) {
+        return std::nullopt;
+    }
+
+    // Prefer routes that end on every territory we need to defend.
+    auto defended = [&](const std::vector<Route>& routes) {
+        return std::all_of(defenses.begin(), defenses.end(), [&](const auto& dest) {
+            return std::any_of(routes.begin(), routes.end(),
+                               [&](const Route& route) { return route.back() == dest.first; });
+        });
+    };
+    if (std::any_of(possible.begin(), possible.end(), defended)) {
+        possible.erase(std::remove_if(possible.begin(), possible.end(),
+                                      [&](const auto& routes) { return !defended(routes); }),
+                       possible.end());
+    }
+
+    std::vector<RoutePlan> plans;
+    for (auto& routes : possible) {
+        RoutePlan plan;
+        bool complete = true;
+        for (const auto& route : routes) {
+            std::vector<int> defenders;
+            for (std::size_t i = 1; i < route.size(); ++i) {
+                defenders.push_back(route[i]->forces);
+            }
+            int survivors = 1;
+            for (const auto& [territory, count] : defenses) {
+                if (territory == route.front()) {
+                    survivors = count;
+                    break;
+                }
+            }
+            auto needed = needed_attackers(defenders, route.front()->forces, prob, survivors);
+            if (!needed) {
+                complete = false;
+                break;
+            }
+            plan.needed.push_back(*needed);
+        }
+        if (!complete) {
+            // Out of budget: settle for the plans already costed.
+            break;
+        }
+        plan.routes = std::move(routes);
+        plans.push_back(std::move(plan));
+    }
+    if (plans.empty()) {
+        return std::nullopt;
+    }
+    auto total = [](const RoutePlan& plan) {
+        return std::accumulate(plan.needed.begin(), plan.needed.end(), 0);
+    };
+    std::stable_sort(plans.begin(), plans.end(),
+                     [&](const RoutePlan& a, const RoutePlan& b) { return total(a) < total(b); });
+    return std::move(plans.front());
+}
+
+std::unordered_map<Territory*, int> ChronAI::reinforce(int available) {
+    strategy();
+    plans_.clear();
+
+    Allocation result;
+    for (auto* territory : owned_territories()) {
+        if (!territory->border()) {
+            continue;
+        }
+        int needed = 0;
+        if (priority_[DefendArea] > 0 && territory->area->owner() == &player_) {
+            needed = needed_reinforcements(territory, priority_[DefendArea]);
+        } else if (priority_[DefendConnected] > 0 && world_.distance(*territory, *seed_) >= 0) {
+            needed = needed_reinforcements(territory, priority_[DefendConnected]);
+        } else if (priority_[DefendIsolated] > 0) {
+            needed = needed_reinforcements(territory, priority_[DefendIsolated]);
+        }
+        if (needed) {
+            result[territory] = needed;
+        }
+    }
+
+    int wanted = result.total();
+    for (int i = available; i < wanted; ++i) {
+        auto entry = result.entries.begin() + rng_.randbelow(static_cast<int>(result.entries.size()));
+        if (--entry->second == 0) {
+            result.entries.erase(entry);
+        }
+    }
+    // Negative when defence alone wanted more than we have; then no plan fits.
+    int remaining = available - wanted;
+
+    std::vector<Territory*> adjacent;
+    std::vector<char> is_adjacent(world_.territory_list.size(), 0);
+    for (auto* territory : owned_territories()) {
+        for (auto* adj : territory->neighbours(Side::Hostile)) {
+            if (!is_adjacent[adj->index]) {
+                is_adjacent[adj->index] = 1;
+                adjacent.push_back(adj);
+            }
+        }
+    }
+
+    std::vector<char> planned(world_.territory_list.size(), 0);
+    int our_strength = player_forces(player_) + game_.reinforcement_count(player_);
+    auto owner_strength = [&](const Territory* t) {
+        return player_forces(*t->owner) + game_.reinforcement_count(*t->owner);
+    };
+    auto by = [](auto key) {
+        return [key](const AttackEvaluation& a, const AttackEvaluation& b) { return key(a) < key(b); };
+    };
+
+    for (Priority pri : {TakeArea, ShortenBorder, TargetStronger, TargetWeaker}) {
+        if (available == 0 || priority_[pri] <= 0) {
+            continue;
+        }
+        std::vector<AttackEvaluation> possible;
+        if (pri == TakeArea) {
+            for (auto* area : world_.area_list) {
+                bool present = std::any_of(area->territories.begin(), area->territories.end(),
+                                           [&](const Territory* t) { return t->owner == &player_; });
+                if (!present || area->owner() != nullptr) {
+                    continue;
+                }
+                std::vector<Territory*> needed;
+                for (auto* territory : area->territories) {
+                    if (territory->owner != &player_) {
+                        needed.push_back(territory);
+                    }
+                }
+                if (std::any_of(needed.begin(), needed.end(),
+                                [&](const Territory* t) { return planned[t->index]; })) {
+                    continue;
+                }
+                possible.push_back(evaluate_attack(needed));
+            }
+            std::stable_sort(possible.begin(), possible.end(), by([](const AttackEvaluation& e) {
+                                 return e.resistance - e.freed_forces;
+                             }));
+        } else if (pri == ShortenBorder) {
+            for (auto* adj : adjacent) {
+                if (!planned[adj->index]) {
+                    possible.push_back(evaluate_attack({adj}));
+                }
+            }
+            for (std::size_t i = 0; i + 1 < adjacent.size(); ++i) {
+                for (std::size_t j = i + 1; j < adjacent.size(); ++j) {
+                    Territory* a1 = adjacent[i];
+                    Territory* a2 = adjacent[j];
+                    if (!planned[a1->index] && !planned[a2->index] && a1->connect.count(a2)) {
+                        possible.push_back(evaluate_attack({a1, a2}));
+                    }
+                }
+            }
+            std::stable_sort(possible.begin(), possible.end(), by([](const AttackEvaluation& e) {
+                                 return e.resistance + e.border_hostiles - e.freed_forces;
+                             }));
+        } else {
+            bool stronger = pri == TargetStronger;
+            for (auto* adj : adjacent) {
+                if (!planned[adj->index] && (owner_strength(adj) > our_strength) == stronger) {
+                    possible.push_back(evaluate_attack({adj}));
+                }
+            }
+            std::stable_sort(possible.begin(), possible.end(), by([](const AttackEvaluation& e) {
+                                 return e.resistance - e.enemy_reinforcements;
+                             }));
+        }
+
+        for (const auto& evaluation : possible) {
+            if (charge_nodes(0)) {
+                break;
+            }
+            Defenses defenses;
+            for (auto* territory : evaluation.new_borders) {
+                defenses.emplace_back(territory, static_cast<int>(4 * priority_[pri]));
+            }
+            auto plan = plan_attack(evaluation.new_inland, evaluation.taken, defenses, priority_[pri]);
+            if (!plan) {
+                continue;
+            }
+            bool touched = false;
+            int needed_total = 0;
+            for (std::size_t i = 0; i < plan->routes.size(); ++i) {
+                const Route& route = plan->routes[i];
+                plan->needed[i] = std::max(plan->needed[i] - route.front()->forces, 0);
+                needed_total += plan->needed[i];
+                for (auto* territory : route) {
+                    touched = touched || planned[territory->index];
+                }
+            }
+            if (needed_total > remaining || touched) {
+                continue;
+            }
+            for (std::size_t i = 0; i < plan->routes.size(); ++i) {
+                Route& route = plan->routes[i];
+                result[route.front()] += plan->needed[i];
+                for (auto* territory : route) {
+                    planned[territory->index] = 1;
+                }
+                remaining -= plan->needed[i];
+                plans_.push_back(std::move(route));
+            }
+        }
+    }
+
+    if (remaining > 0) {
+        std::vector<Territory*> border;
+        for (auto* territory : owned_territories()) {
+            if (territory->border()) {
+                border.push_back(territory);
+            }
+        }
+        for (int i = 0; i < remaining && !border.empty(); ++i) {
+            ++result[pick(rng_, border)];
+        }
+    }
+
+    std::unordered_map<Territory*, int> allocations;
+    for (const auto& [territory, count] : result.entries) {
+        allocations[territory] += count;
+    }
+    return allocations;
+}
+
+std::vector<AttackPlan> ChronAI::attack() {
+    next_plan_ = 0;
+    next_step_ = 0;
+    next_territory_ = 0;
+    source_ = nullptr;
+    return {};
+}
+
+std::optional<AttackPlan> ChronAI::next_attack() {
+    while (next_plan_ < plans_.size()) {
+        const Route& route = plans_[next_plan_];
+        if (next_step_ + 1 < route.size()) {
+            ++next_step_;
+            return AttackPlan{route[next_step_ - 1], route[next_step_], {}, {}};
+        }
+        ++next_plan_;
+        next_step_ = 0;
+    }
+
+    double threshold = priority_[AttackAny];
+    if (threshold <= 0) {
+        return std::nullopt;
+    }
+    const auto& territories = world_.territory_list;
+    while (true) {
+        if (source_ == nullptr) {
+            while (next_territory_ < territories.size() && territories[next_territory_]->owner != &player_) {
+                ++next_territory_;
+            }
+            if (next_territory_ == territories.size()) {
+                return std::nullopt;
+            }
+            source_ = territories[next_territory_++];
+            next_target_ = source_->neighbours(Side::Hostile).begin();
+        }
+        while (next_target_ != source_->neighbours(Side::Hostile).end()) {
+            Territory* target = *next_target_++;
+            if (battle_odds(source_->forces, target->forces).victory > threshold) {
+                return AttackPlan{source_, target, {}, [](int) { return 1; }};
+            }
+        }
+        source_ = nullptr;
+    }
+}
+
+std::optional<MoveOrder> ChronAI::freemove() {
+    Territory* dest = nullptr;
+    Territory* src = nullptr;
+    for (auto* territory : owned_territories()) {
+        if (territory->border()) {
+            if (dest == nullptr || territory->forces < dest->forces) {
+                dest = territory;
+            }
+        } else if (src == nullptr || territory->forces >= src->forces) {
+            src = territory;
+        }
+    }
+    if (src == nullptr || dest == nullptr) {
+        return std::nullopt;
+    }
+    return MoveOrder{src, dest, src->forces - 1};
+}
+
+}  // namespace pyrisk
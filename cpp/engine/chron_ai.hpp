@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ai.hpp"
+
+namespace pyrisk {
+
+// Port of ai/chron.py: picks a strategy from its relative strength each turn,
+// reinforces against simulated worst-case attacks and plans multi-step
+// attacks towards strategic goals.
+class ChronAI : public AI {
+public:
+    using AI::AI;
+
+    void start() override;
+    std::string save_state() const override;
+    void load_state(const std::string& state) override;
+    Territory* initial_placement(const std::vector<Territory*>& empty, int remaining) override;
+    std::unordered_map<Territory*, int> reinforce(int available) override;
+    std::vector<AttackPlan> attack() override;
+    std::optional<AttackPlan> next_attack() override;
+    std::optional<MoveOrder> freemove() override;
+
+private:
+    enum Priority {
+        DefendArea,
+        DefendConnected,
+        DefendIsolated,
+        TakeArea,
+        TargetStronger,
+        TargetWeaker,
+        ShortenBorder,
+        AttackAny,
+        kPriorities
+    };
+
+    using Route = std::vector<Territory*>;
+    using Defenses = std::vector<std::pair<Territory*, int>>;
+
+    // The board after `taken` fell to us with one army each, relative to now.
+    struct AttackEvaluation {
+        std::vector<Territory*> taken;
+        std::vector<Territory*> new_borders;
+        std::vector<Territory*> new_inland;
+        int reinforcements{0};
+        int enemy_reinforcements{0};
+        int resistance{0};
+        int freed_forces{0};
+        int border_hostiles{0};
+    };
+
+    struct RoutePlan {
+        std::vector<Route> routes;
+        std::vector<int> needed;
+    };
+
+    int player_forces(const Player& player) const;
+    bool owns_area(const Player& player) const;
+    std::size_t area_rank(const Area* area) const;
+    void set_seed(Territory* seed);
+
+    // These charge one node per battle they evaluate. Once the decision
+    // budget is spent, needed_defenders() answers with the garrison it knows
+    // holds and needed_attackers() with nullopt, so the plan is dropped.
+    int needed_reinforcements(Territory* territory, double prob);
+    int needed_defenders(const std::vector<int>& worst_case, int defenders, double prob);
+    std::optional<int> needed_attackers(const std::vector<int>& defenders, int attackers,
+                                        double prob, int survivors);
+    void strategy();
+    AttackEvaluation evaluate_attack(const std::vector<Territory*>& taken) const;
+    std::optional<std::vector<Route>> random_walk(const std::vector<Territory*>& srcs,
+                                                  const std::vector<Territory*>& via,
+                                                  const Defenses& dests);
+    std::optional<RoutePlan> plan_attack(const std::vector<Territory*>& srcs,
+                                         const std::vector<Territory*>& targets,
+                                         const Defenses& defenses, double prob, int tries = 100);
+
+    Territory* seed_{nullptr};
+    std::vector<Area*> area_priority_;
+    std::vector<Route> plans_;
+    std::array<double, kPriorities> priority_{};
+
+    // attack() generator state: first the planned routes, then attack-any.
+    std::size_t next_plan_{0};
+    std::size_t next_step_{0};
+    std::size_t next_territory_{0};
+    Territory* source_{nullptr};
+    NeighbourView::iterator next_target_;
+};
+
+}  // namespace pyrisk
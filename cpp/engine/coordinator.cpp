@@ -0,0 +1,263 @@
+#include "coordinator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace pyrisk {
+namespace {
+
+constexpr std::uint32_t kNoChunk = 0xFFFFFFFF;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                  std::atomic<std::uint32_t>::is_always_lock_free &&
+                  std::atomic<std::uint8_t>::is_always_lock_free,
+              "shared-memory counters must be lock-free to work across processes");
+
+struct SharedSeed {
+    std::atomic<std::uint8_t> status{0};  // SeedRecord::Status
+    std::atomic<std::uint32_t> attempts{0};
+    std::int32_t winner{-1};
+    std::uint32_t turns{0};
+    std::uint8_t adjudicated{0};
+};
+
+struct alignas(64) SharedTotals {
+    std::atomic<std::uint64_t> next_chunk{0};
+    std::atomic<std::uint64_t> games{0};
+    std::atomic<std::uint64_t> failed{0};
+    std::atomic<std::uint64_t> adjudicated{0};
+    std::atomic<std::uint64_t> turns{0};
+};
+
+// One anonymous MAP_SHARED mapping, inherited by every forked worker:
+// totals, per-player win counters, the chunk each worker slot holds, and
+// one result slot per seed.
+class SharedRegion {
+public:
+    SharedRegion(std::size_t players, std::size_t workers, std::size_t seeds) {
+        auto align = [](std::size_t offset) {
+            return (offset + alignof(SharedSeed) - 1) / alignof(SharedSeed) * alignof(SharedSeed);
+        };
+        wins_offset_ = sizeof(SharedTotals);
+        held_offset_ = align(wins_offset_ + players * sizeof(std::atomic<std::uint64_t>));
+        seeds_offset_ = align(held_offset_ + workers * sizeof(std::atomic<std::uint32_t>));
+        bytes_ = seeds_offset_ + seeds * sizeof(SharedSeed);
+
+        void* base = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+                            -1, 0);
+        if (base == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        base_ = static_cast<unsigned char*>(base);
+        new (base_) SharedTotals();
+        for (std::size_t i = 0; i < players; ++i) {
+            new (&win(i)) std::atomic<std::uint64_t>(0);
+        }
+        for (std::size_t i = 0; i < workers; ++i) {
+            new (&held(i)) std::atomic<std::uint32_t>(kNoChunk);
+        }
+        for (std::size_t i = 0; i < seeds; ++i) {
+            new (&seed(i)) SharedSeed();
+        }
+    }
+
+    ~SharedRegion() { ::munmap(base_, bytes_); }
+
+    SharedRegion(const SharedRegion&) = delete;
+    SharedRegion& operator=(const SharedRegion&) = delete;
+
+    SharedTotals& totals() { return *reinterpret_cast<SharedTotals*>(base_); }
+    std::atomic<std::uint64_t>& win(std::size_t player) {
+        return reinterpret_cast<std::atomic<std::uint64_t>*>(base_ + wins_offset_)[player];
+    }
+    std::atomic<std::uint32_t>& held(std::size_t slot) {
+        return reinterpret_cast<std::atomic<std::uint32_t>*>(base_ + held_offset_)[slot];
+    }
+    SharedSeed& seed(std::size_t index) {
+        return reinterpret_cast<SharedSeed*>(base_ + seeds_offset_)[index];
+    }
+
+private:
+    std::size_t wins_offset_{0};
+    std::size_t held_offset_{0};
+    std::size_t seeds_offset_{0};
+    std::size_t bytes_{0};
+    unsigned char* base_{nullptr};
+};
+
+bool settle(SharedSeed& slot, SeedRecord::Status status) {
+    auto pending = static_cast<std::uint8_t>(SeedRecord::Status::Pending);
+    return slot.status.compare_exchange_strong(pending, static_cast<std::uint8_t>(status),
+                                               std::memory_order_acq_rel);
+}
+
+// Worker body: finish the chunk this slot held when its previous process
+// died, then keep claiming chunks until the queue is empty.
+void work(SharedRegion& shared, std::size_t slot, const std::vector<std::uint32_t>& seeds,
+          const CoordinatorConfig& config, const SeedRunner& runner) {
+    auto& totals = shared.totals();
+    auto& held = shared.held(slot);
+    std::size_t chunks = (seeds.size() + config.chunk - 1) / config.chunk;
+    while (true) {
+        std::uint32_t chunk = held.load(std::memory_order_acquire);
+        if (chunk == kNoChunk) {
+            // Publish the claim before taking it, so a crash in between
+            // leaves the chunk with this slot rather than with nobody.
+            std::uint64_t next = totals.next_chunk.load(std::memory_order_acquire);
+            do {
+                if (next >= chunks) {
+                    return;
+                }
+                held.store(static_cast<std::uint32_t>(next), std::memory_order_release);
+            } while (!totals.next_chunk.compare_exchange_weak(next, next + 1,
+                                                              std::memory_order_acq_rel));
+            chunk = static_cast<std::uint32_t>(next);
+        }
+
+        std::size_t begin = static_cast<std::size_t>(chunk) * config.chunk;
+        std::size_t end = std::min(seeds.size(), begin + config.chunk);
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& slot_state = shared.seed(i);
+            if (slot_state.status.load(std::memory_order_acquire) !=
+                static_cast<std::uint8_t>(SeedRecord::Status::Pending)) {
+                continue;
+            }
+            if (slot_state.attempts.fetch_add(1, std::memory_order_acq_rel) >= config.max_attempts) {
+                if (settle(slot_state, SeedRecord::Status::Failed)) {
+                    totals.failed.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+            SeedOutcome outcome = runner(seeds[i]);
+            slot_state.winner = outcome.winner;
+            slot_state.turns = outcome.turns;
+            slot_state.adjudicated = outcome.adjudicated ? 1 : 0;
+            // A crash between claiming and publishing may have let another
+            // worker run this seed too; only the first result counts.
+            if (settle(slot_state, SeedRecord::Status::Done)) {
+                totals.games.fetch_add(1, std::memory_order_relaxed);
+                totals.turns.fetch_add(outcome.turns, std::memory_order_relaxed);
+                if (outcome.adjudicated) {
+                    totals.adjudicated.fetch_add(1, std::memory_order_relaxed);
+                }
+                auto winner = static_cast<std::size_t>(outcome.winner);
+                if (outcome.winner >= 0 && winner < config.players) {
+                    shared.win(winner).fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        held.store(kNoChunk, std::memory_order_release);
+    }
+}
+
+}  // namespace
+
+ProcessCoordinator::ProcessCoordinator(CoordinatorConfig config, SeedRunner runner)
+    : config_(config), runner_(std::move(runner)) {
+    if (config_.workers == 0 || config_.chunk == 0) {
+        throw std::invalid_argument("coordinator needs at least one worker and a non-empty chunk");
+    }
+}
+
+std::vector<SeedRecord> ProcessCoordinator::run(const std::vector<std::uint32_t>& seeds) {
+    SharedRegion shared(config_.players, config_.workers, seeds.size());
+
+    // Buffered output would otherwise be written once per child.
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    auto spawn = [&](std::size_t slot) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            throw std::system_error(errno, std::generic_category(), "fork");
+        }
+        if (pid == 0) {
+            int code = 0;
+            try {
+                work(shared, slot, seeds, config_, runner_);
+            } catch (...) {
+                code = 2;
+            }
+            // Skip the parent's atexit handlers and static destructors.
+            ::_exit(code);
+        }
+        return pid;
+    };
+
+    std::vector<pid_t> pids(config_.workers);
+    for (std::size_t slot = 0; slot < config_.workers; ++slot) {
+        pids[slot] = spawn(slot);
+    }
+
+    summary_ = {};
+    std::size_t running = config_.workers;
+    while (running > 0) {
+        int status = 0;
+        pid_t pid = ::waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "waitpid");
+        }
+        auto it = std::find(pids.begin(), pids.end(), pid);
+        if (it == pids.end()) {
+            continue;
+        }
+        auto slot = static_cast<std::size_t>(it - pids.begin());
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            *it = -1;
+            --running;
+            continue;
+        }
+        // Every crash inside a game uses up one of that seed's attempts, so
+        // more crashes than this means workers die outside of games.
+        if (++summary_.crashes > seeds.size() * config_.max_attempts + config_.workers) {
+            for (pid_t other : pids) {
+                if (other > 0 && other != pid) {
+                    ::kill(other, SIGKILL);
+                    ::waitpid(other, nullptr, 0);
+                }
+            }
+            throw std::runtime_error("tournament workers keep crashing");
+        }
+        *it = spawn(slot);
+    }
+
+    auto& totals = shared.totals();
+    summary_.games = totals.games.load();
+    summary_.failed = totals.failed.load();
+    summary_.adjudicated = totals.adjudicated.load();
+    summary_.turns = totals.turns.load();
+    summary_.wins.resize(config_.players);
+    for (std::size_t i = 0; i < config_.players; ++i) {
+        summary_.wins[i] = shared.win(i).load();
+    }
+
+    std::vector<SeedRecord> records(seeds.size());
+    for (std::size_t i = 0; i < seeds.size(); ++i) {
+        auto& slot = shared.seed(i);
+        records[i].seed = seeds[i];
+        records[i].status = static_cast<SeedRecord::Status>(slot.status.load());
+        records[i].attempts = slot.attempts.load();
+        if (records[i].status == SeedRecord::Status::Done) {
+            records[i].outcome = {slot.winner, slot.adjudicated != 0, slot.turns};
+        }
+    }
+    return records;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace pyrisk {
+
+// What a worker reports for one seed; `winner` is an index into the
+// caller's player list, or -1 when nobody won.
+struct SeedOutcome {
+    std::int32_t winner{-1};
+    bool adjudicated{false};
+    std::uint32_t turns{0};
+};
+
+using SeedRunner = std::function<SeedOutcome(std::uint32_t seed)>;
+
+struct CoordinatorConfig {
+    std::size_t workers{1};
+    std::size_t players{2};
+    std::size_t chunk{8};          // seeds handed out per queue claim
+    std::uint32_t max_attempts{3}; // a seed that crashes this often is given up
+};
+
+struct SeedRecord {
+    enum class Status : std::uint8_t { Pending, Done, Failed };
+
+    std::uint32_t seed{0};
+    Status status{Status::Pending};
+    std::uint32_t attempts{0};
+    SeedOutcome outcome{};
+};
+
+struct CoordinatorSummary {
+    std::uint64_t games{0};
+    std::uint64_t failed{0};
+    std::uint64_t adjudicated{0};
+    std::uint64_t turns{0};
+    std::vector<std::uint64_t> wins;  // by player index
+    std::uint64_t crashes{0};         // workers that died and were replaced
+};
+
+// Runs seeds in forked worker processes on this machine. Workers claim
+// chunks of seeds from a work queue in anonymous shared memory and write
+// each outcome into a shared result table, bumping shared atomic totals.
+// When a worker dies, a replacement is forked in its slot and first
+// finishes the seeds of the chunk it was holding. `runner` runs in the
+// children, so it must not rely on threads started by the parent.
+class ProcessCoordinator {
+public:
+    ProcessCoordinator(CoordinatorConfig config, SeedRunner runner);
+
+    std::vector<SeedRecord> run(const std::vector<std::uint32_t>& seeds);
+    const CoordinatorSummary& summary() const { return summary_; }
+
+private:
+    CoordinatorConfig config_;
+    SeedRunner runner_;
+    CoordinatorSummary summary_;
+};
+
+}  // namespace pyrisk
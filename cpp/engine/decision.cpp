@@ -0,0 +1,75 @@
+#include "decision.hpp"
+
+#include <algorithm>
+
+namespace pyrisk {
+
+void DecisionContext::begin(const DecisionBudget& budget) {
+    cancelled_.store(false, std::memory_order_relaxed);
+    nodes_ = 0;
+    node_limit_ = budget.nodes;
+    has_deadline_ = budget.wall.count() > 0;
+    deadline_ = has_deadline_ ? Clock::now() + budget.wall : Clock::time_point{};
+}
+
+bool DecisionContext::charge(std::uint64_t nodes) {
+    nodes_ += nodes;
+    if (cancelled()) {
+        return true;
+    }
+    if (node_limit_ != 0 && nodes_ >= node_limit_) {
+        return true;
+    }
+    return has_deadline_ && Clock::now() >= deadline_;
+}
+
+void DecisionContext::cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    std::int64_t ns = std::max<std::int64_t>(latency.count(), 0);
+    std::uint64_t micros = static_cast<std::uint64_t>(ns / 1000);
+    std::size_t bucket = 0;
+    while (micros > 0 && bucket + 1 < kBuckets) {
+        micros >>= 1;
+        ++bucket;
+    }
+    ++buckets_[bucket];
+    ++count_;
+    total_ns_ += ns;
+    max_ns_ = std::max(max_ns_, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    total_ns_ += other.total_ns_;
+    max_ns_ = std::max(max_ns_, other.max_ns_);
+}
+
+std::chrono::nanoseconds LatencyHistogram::quantile(double q) const {
+    if (count_ == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(count_ - 1));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets_[i];
+        if (seen > rank) {
+            // Report the bucket's upper bound, capped by the observed maximum.
+            std::int64_t upper = static_cast<std::int64_t>(1000) << i;
+            return std::chrono::nanoseconds(std::min(upper, max_ns_));
+        }
+    }
+    return max();
+}
+
+void DecisionStats::merge(const DecisionStats& other) {
+    latency.merge(other.latency);
+    timeouts += other.timeouts;
+    over_budget += other.over_budget;
+    nodes += other.nodes;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace pyrisk {
+
+// Limits applied to a single AI decision. Zero means unlimited.
+struct DecisionBudget {
+    std::chrono::microseconds wall{0};
+    std::uint64_t nodes{0};
+
+    bool unlimited() const { return wall.count() == 0 && nodes == 0; }
+};
+
+// Shared between the driver and an AI while one decision is in flight. AIs
+// poll it through AI::charge_nodes() and should return their best answer so
+// far once it reports the budget as spent.
+class DecisionContext {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void begin(const DecisionBudget& budget);
+    bool charge(std::uint64_t nodes);
+    void cancel();
+
+    bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+    std::uint64_t nodes() const { return nodes_; }
+    Clock::time_point deadline() const { return deadline_; }
+    bool has_deadline() const { return has_deadline_; }
+
+private:
+    std::atomic<bool> cancelled_{false};
+    std::uint64_t nodes_{0};
+    std::uint64_t node_limit_{0};
+    bool has_deadline_{false};
+    Clock::time_point deadline_{};
+};
+
+class LatencyHistogram {
+public:
+    // Bucket i counts decisions taking [2^(i-1), 2^i) microseconds; bucket 0
+    // holds everything under one microsecond.
+    static constexpr std::size_t kBuckets = 32;
+
+    void record(std::chrono::nanoseconds latency);
+    void merge(const LatencyHistogram& other);
+    std::chrono::nanoseconds quantile(double q) const;
+
+    std::uint64_t count() const { return count_; }
+    std::chrono::nanoseconds total() const { return std::chrono::nanoseconds(total_ns_); }
+    std::chrono::nanoseconds max() const { return std::chrono::nanoseconds(max_ns_); }
+    const std::array<std::uint64_t, kBuckets>& buckets() const { return buckets_; }
+
+private:
+    std::array<std::uint64_t, kBuckets> buckets_{};
+    std::uint64_t count_{0};
+    std::int64_t total_ns_{0};
+    std::int64_t max_ns_{0};
+};
+
+// Per-seat decision latencies for one game, timed while the AI itself runs.
+struct DecisionStats {
+    LatencyHistogram latency;
+    std::uint64_t timeouts{0};     // replaced by the default action
+    std::uint64_t over_budget{0};  // answered past the budget, or cut short by it, and kept
+    std::uint64_t nodes{0};
+
+    void merge(const DecisionStats& other);
+};
+
+}  // namespace pyrisk
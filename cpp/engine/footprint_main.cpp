@@ -0,0 +1,204 @@
+// Reports the memory one game takes in each representation, so regressions
+// in the live structures or the packed encoding show up as numbers.
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ai_registry.hpp"
+#include "packed_state.hpp"
+#include "world_data.hpp"
+
+namespace {
+
+// Live heap bytes and allocation calls, tracked by the replacement operator
+// new/delete below.
+std::atomic<std::size_t> live_bytes{0};
+std::atomic<std::size_t> allocations{0};
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+void* counted_alloc(std::size_t size) {
+    auto* block = static_cast<unsigned char*>(std::malloc(size + kHeader));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    std::memcpy(block, &size, sizeof(size));
+    live_bytes.fetch_add(size, std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return block + kHeader;
+}
+
+void counted_free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto* block = static_cast<unsigned char*>(ptr) - kHeader;
+    std::size_t size;
+    std::memcpy(&size, block, sizeof(size));
+    live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    std::free(block);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void operator delete(void* ptr) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { counted_free(ptr); }
+
+namespace {
+
+using namespace pyrisk;
+
+struct Sizes {
+    std::size_t total{0};
+    std::size_t max{0};
+    std::size_t count{0};
+
+    void add(std::size_t bytes) {
+        total += bytes;
+        max = std::max(max, bytes);
+        ++count;
+    }
+};
+
+void report(const char* name, const Sizes& sizes) {
+    std::cout << name << ": mean=" << (sizes.count ? sizes.total / sizes.count : 0)
+              << "B max=" << sizes.max << "B" << std::endl;
+}
+
+std::vector<std::string> player_names(std::size_t players) {
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < players; ++i) {
+        names.push_back("P" + std::to_string(i + 1));
+    }
+    return names;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t games = 20;
+    std::size_t max_turns = 500;
+    std::string players = "StupidAI,DeterministicAI";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--games") == 0) {
+            games = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--max-turns") == 0) {
+            max_turns = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--players") == 0) {
+            players = argv[i + 1];
+        } else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<GameDriver::AiFactory> factories;
+    for (std::size_t start = 0; start <= players.size();) {
+        std::size_t end = std::min(players.find(',', start), players.size());
+        std::string ai = players.substr(start, end - start);
+        start = end + 1;
+        auto factory = find_ai(ai);
+        if (!factory) {
+            std::cerr << "unknown AI " << ai << std::endl;
+            return 1;
+        }
+        factories.push_back(*factory);
+    }
+    auto names = player_names(factories.size());
+
+    // Static structures: measured once, they do not depend on the game.
+    std::size_t before = live_bytes.load();
+    World world;
+    world.load(kAreas, kConnectionData);
+    std::size_t world_bytes = live_bytes.load() - before + sizeof(World);
+
+    before = live_bytes.load();
+    std::vector<Player> roster;
+    for (const auto& name : names) {
+        roster.emplace_back(name);
+    }
+    World scratch_world;
+    scratch_world.load(kAreas, kConnectionData);
+    Game scratch(std::move(scratch_world), roster);
+    std::size_t game_bytes = live_bytes.load() - before + sizeof(Game);
+
+    Sizes driver_start;
+    Sizes driver_end;
+    Sizes packed;
+    Sizes packed_heap;
+    std::size_t round_trips = 0;
+    for (std::size_t seed = 0; seed < games; ++seed) {
+        before = live_bytes.load();
+        World game_world;
+        game_world.load(kAreas, kConnectionData);
+        GameDriver* live = nullptr;
+        auto sample = [&](const BoardEvent& event) {
+            if (event.kind != EventKind::Conquer || live == nullptr) {
+                return;
+            }
+            // Round-trip every sample through the scratch game.
+            PackedState state(live->game(), live->turn_state());
+            TurnState turn;
+            state.apply(scratch, turn);
+            if (PackedState(scratch, turn) != state || !(turn == live->turn_state()) ||
+                scratch.hash() != live->game().hash()) {
+                std::cerr << "packed state round trip failed at seed " << seed << std::endl;
+                std::exit(1);
+            }
+            ++round_trips;
+            packed.add(state.size());
+            packed_heap.add(sizeof(PackedState) + state.bytes().capacity());
+        };
+        auto driver = std::make_unique<GameDriver>(std::move(game_world), names, factories,
+                                                   /*deal=*/false, EventLogger{},
+                                                   static_cast<std::uint32_t>(seed));
+        driver->set_logger_events(kNoEvents);
+        driver->game().set_observer(sample);
+        driver->set_limits({max_turns, 0});
+        driver_start.add(live_bytes.load() - before + sizeof(GameDriver));
+        live = driver.get();
+        driver->play();
+        driver_end.add(live_bytes.load() - before + sizeof(GameDriver));
+    }
+
+    // The same games on one driver reset between them: reset() itself must
+    // not allocate, and the heap should stop growing once buffers are warm.
+    std::size_t reset_allocations = 0;
+    Sizes reused_end;
+    {
+        before = live_bytes.load();
+        World reused_world;
+        reused_world.load(kAreas, kConnectionData);
+        GameDriver reused(std::move(reused_world), names, factories, /*deal=*/false, {}, 0);
+        reused.set_logger_events(kNoEvents);
+        reused.set_limits({max_turns, 0});
+        for (std::size_t seed = 0; seed < games; ++seed) {
+            std::size_t counted = allocations.load();
+            reused.reset(static_cast<std::uint32_t>(seed));
+            reset_allocations += allocations.load() - counted;
+            reused.play();
+            reused_end.add(live_bytes.load() - before + sizeof(GameDriver));
+        }
+    }
+
+    std::cout << "games=" << games << " players=" << players << " samples=" << round_trips
+              << std::endl;
+    std::cout << "world: " << world_bytes << "B" << std::endl;
+    std::cout << "game: " << game_bytes << "B" << std::endl;
+    report("driver (start)", driver_start);
+    report("driver (end)", driver_end);
+    report("reused driver (end)", reused_end);
+    std::cout << "allocations in reset(): " << reset_allocations << std::endl;
+    report("packed", packed);
+    report("packed (with vector)", packed_heap);
+    return 0;
+}
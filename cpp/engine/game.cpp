@@ -7,6 +7,9 @@
 #include <sstream>
 #include <stdexcept>
 
+#include "binary_io.hpp"
+#include "zobrist.hpp"
+
 namespace pyrisk {
 
 Player::Player(std::string name) : name(std::move(name)) {}
@@ -15,9 +18,7 @@ Territory::Territory(std::string name_in, Area* area_in)
     : name(std::move(name_in)), area(area_in) {}
 
 bool Territory::border() const {
-    return std::any_of(connect.begin(), connect.end(), [&](Territory* t) {
-        return t->owner && t->owner != owner;
-    });
+    return !neighbours(Side::Enemy).empty();
 }
 
 bool Territory::area_owned() const {
@@ -25,30 +26,35 @@ bool Territory::area_owned() const {
 }
 
 bool Territory::area_border() const {
-    return std::any_of(connect.begin(), connect.end(), [&](Territory* t) { return t->area != area; });
+    return !neighbours(Side::Any, Region::OtherArea).empty();
+}
+
+namespace {
+
+Side side_of(std::optional<bool> friendly) {
+    if (!friendly.has_value()) {
+        return Side::Any;
+    }
+    return friendly.value() ? Side::Friendly : Side::Hostile;
+}
+
+Region region_of(std::optional<bool> thisarea) {
+    if (!thisarea.has_value()) {
+        return Region::Any;
+    }
+    return thisarea.value() ? Region::SameArea : Region::OtherArea;
 }
 
+}  // namespace
+
 std::vector<Territory*> Territory::adjacent(std::optional<bool> friendly,
                                             std::optional<bool> thisarea) const {
-    std::vector<Territory*> out;
-    for (auto* t : connect) {
-        if (friendly.has_value() && friendly.value() != (t->owner == owner)) {
-            continue;
-        }
-        if (thisarea.has_value() && thisarea.value() != (t->area == area)) {
-            continue;
-        }
-        out.push_back(t);
-    }
-    return out;
+    auto view = neighbours(side_of(friendly), region_of(thisarea));
+    return std::vector<Territory*>(view.begin(), view.end());
 }
 
 int Territory::adjacent_forces(std::optional<bool> friendly, std::optional<bool> thisarea) const {
-    int total = 0;
-    for (auto* t : adjacent(friendly, thisarea)) {
-        total += t->forces;
-    }
-    return total;
+    return neighbours(side_of(friendly), region_of(thisarea)).forces();
 }
 
 Area::Area(std::string name_in, int value_in) : name(std::move(name_in)), value(value_in) {}
@@ -73,18 +79,6 @@ int Area::forces() const {
     return total;
 }
 
-std::unordered_set<Area*> Area::adjacent() const {
-    std::unordered_set<Area*> adj;
-    for (auto* t : territories) {
-        for (auto* other : t->connect) {
-            if (other->area != this) {
-                adj.insert(other->area);
-            }
-        }
-    }
-    return adj;
-}
-
 Territory* World::territory(const std::string& t) {
     auto it = territories.find(t);
     if (it != territories.end()) {
@@ -156,15 +150,118 @@ void World::load(const std::unordered_map<std::string, AreaDefinition>& area_def
 
     for (auto& [_, territory_ptr] : territories) {
         auto* t = territory_ptr.get();
+        t->neighbour_list.assign(t->connect.begin(), t->connect.end());
         std::vector<char> avail = ords;
         for (auto* c : t->connect) {
             avail.erase(std::remove(avail.begin(), avail.end(), c->ord), avail.end());
         }
-        if (avail.empty()) {
-            throw std::runtime_error("No available ord symbol for territory");
+        // The ord is only drawn on screen; dense generated maps can use up
+        // every symbol around a territory.
+        t->ord = avail.empty() ? '*' : avail.back();
+    }
+
+    territory_list.clear();
+    for (auto& [_, territory_ptr] : territories) {
+        territory_ptr->index = territory_list.size();
+        territory_list.push_back(territory_ptr.get());
+    }
+    std::vector<Territory*> named = territory_list;
+    std::sort(named.begin(), named.end(),
+              [](const Territory* lhs, const Territory* rhs) { return lhs->name < rhs->name; });
+    for (std::size_t rank = 0; rank < named.size(); ++rank) {
+        named[rank]->name_rank = static_cast<std::uint32_t>(rank);
+    }
+    area_list.clear();
+    for (auto& [_, area_ptr] : areas) {
+        area_ptr->index = area_list.size();
+        area_list.push_back(area_ptr.get());
+    }
+    for (auto* a : area_list) {
+        std::vector<char> seen(area_list.size(), 0);
+        for (auto* t : a->territories) {
+            for (auto* other : t->neighbours(Side::Any, Region::OtherArea)) {
+                seen[other->area->index] = 1;
+            }
+        }
+        a->adjacent_areas.clear();
+        for (auto* b : area_list) {
+            if (seen[b->index]) {
+                a->adjacent_areas.push_back(b);
+            }
         }
-        t->ord = avail.back();
     }
+    build_topology();
+}
+
+void World::clear_board() {
+    for (auto* territory : territory_list) {
+        territory->owner = nullptr;
+        territory->forces = 0;
+    }
+}
+
+void World::build_topology() {
+    const std::size_t n = territory_list.size();
+    if (n >= kUnreachable) {
+        throw std::runtime_error("Too many territories for the topology tables");
+    }
+
+    adjacency_offsets.assign(1, 0);
+    adjacency.clear();
+    for (auto* t : territory_list) {
+        auto first = adjacency.size();
+        for (auto* c : t->connect) {
+            adjacency.push_back(static_cast<std::uint32_t>(c->index));
+        }
+        std::sort(adjacency.begin() + static_cast<long>(first), adjacency.end());
+        adjacency_offsets.push_back(static_cast<std::uint32_t>(adjacency.size()));
+    }
+
+    // One BFS per destination: every territory reached from `to` learns
+    // which neighbour leads back towards it.
+    hops_.assign(n * n, kUnreachable);
+    next_hop_.assign(n * n, kUnreachable);
+    std::vector<std::uint32_t> queue(n);
+    for (std::size_t to = 0; to < n; ++to) {
+        std::size_t head = 0;
+        std::size_t tail = 0;
+        hops_[to * n + to] = 0;
+        queue[tail++] = static_cast<std::uint32_t>(to);
+        while (head < tail) {
+            std::uint32_t here = queue[head++];
+            auto here_hops = hops_[here * n + to];
+            for (auto i = adjacency_offsets[here]; i < adjacency_offsets[here + 1]; ++i) {
+                std::uint32_t next = adjacency[i];
+                if (hops_[next * n + to] == kUnreachable) {
+                    hops_[next * n + to] = static_cast<std::uint16_t>(here_hops + 1);
+                    next_hop_[next * n + to] = static_cast<std::uint16_t>(here);
+                    queue[tail++] = next;
+                }
+            }
+        }
+    }
+}
+
+int World::distance(const Territory& from, const Territory& to) const {
+    auto hops = hops_[from.index * territory_list.size() + to.index];
+    return hops == kUnreachable ? -1 : hops;
+}
+
+Territory* World::next_hop(const Territory& from, const Territory& to) const {
+    auto next = next_hop_[from.index * territory_list.size() + to.index];
+    return next == kUnreachable ? nullptr : territory_list[next];
+}
+
+std::vector<Territory*> World::route(const Territory& from, const Territory& to) const {
+    std::vector<Territory*> path;
+    if (distance(from, to) < 0) {
+        return path;
+    }
+    path.push_back(territory_list[from.index]);
+    while (path.back() != &to) {
+        path.push_back(next_hop(*path.back(), to));
+    }
+    return path;
 }
 
 namespace {
@@ -178,7 +275,7 @@ PythonicRNG::PythonicRNG(Mode mode) : mode_(mode) {
 }
 PythonicRNG::PythonicRNG(std::uint32_t seed_value, Mode mode) : mode_(mode) { seed(seed_value); }
 
-void PythonicRNG::init_by_array(const std::vector<std::uint32_t>& key) {
+void PythonicRNG::init_by_array(const std::uint32_t* key, std::size_t key_length) {
     state_[0] = 19650218UL;
     for (std::size_t i = 1; i < kN; ++i) {
         state_[i] =
@@ -187,7 +284,6 @@ void PythonicRNG::init_by_array(const std::vector<std::uint32_t>& key) {
 
     std::size_t i = 1;
     std::size_t j = 0;
-    std::size_t key_length = key.size();
     std::size_t k = kN > key_length ? kN : key_length;
     for (; k > 0; --k) {
         state_[i] = (state_[i] ^ ((state_[i - 1] ^ (state_[i - 1] >> 30)) * 1664525UL)) + key[j] +
@@ -225,24 +321,12 @@ void PythonicRNG::twist() {
     index_ = 0;
 }
 
-std::uint32_t PythonicRNG::extract() {
-    if (index_ >= kN) {
-        twist();
-    }
-    std::uint32_t y = state_[index_++];
-    y ^= (y >> 11);
-    y ^= (y << 7) & 0x9D2C5680UL;
-    y ^= (y << 15) & 0xEFC60000UL;
-    y ^= (y >> 18);
-    return y;
-}
-
 void PythonicRNG::seed(std::uint32_t seed_value) {
     last_seed_ = seed_value;
     if (mode_ == Mode::StdMT) {
         std_engine_.seed(seed_value);
     } else {
-        init_by_array({seed_value});
+        init_by_array(&seed_value, 1);
     }
 }
 void PythonicRNG::set_mode(Mode mode) {
@@ -250,6 +334,45 @@ void PythonicRNG::set_mode(Mode mode) {
     seed(last_seed_);
 }
 
+void PythonicRNG::save(std::ostream& out) const {
+    write_varint(out, static_cast<std::uint64_t>(mode_));
+    write_varint(out, last_seed_);
+    if (mode_ == Mode::StdMT) {
+        std::ostringstream engine;
+        engine << std_engine_;
+        write_string(out, engine.str());
+        return;
+    }
+    write_varint(out, index_);
+    for (auto word : state_) {
+        write_varint(out, word);
+    }
+}
+
+void PythonicRNG::load(std::istream& in) {
+    auto mode = read_varint(in);
+    if (mode > static_cast<std::uint64_t>(Mode::StdMT)) {
+        throw std::runtime_error("unknown RNG mode");
+    }
+    mode_ = static_cast<Mode>(mode);
+    last_seed_ = static_cast<std::uint32_t>(read_varint(in));
+    if (mode_ == Mode::StdMT) {
+        std::istringstream engine(read_string(in));
+        engine >> std_engine_;
+        if (!engine) {
+            throw std::runtime_error("malformed RNG state");
+        }
+        return;
+    }
+    index_ = static_cast<std::size_t>(read_varint(in));
+    if (index_ > kN + 1) {
+        throw std::runtime_error("malformed RNG state");
+    }
+    for (auto& word : state_) {
+        word = static_cast<std::uint32_t>(read_varint(in));
+    }
+}
+
 int PythonicRNG::randint(int low, int high_inclusive) {
     if (high_inclusive < low) {
         throw std::invalid_argument("high must be >= low");
@@ -317,30 +440,34 @@ double PythonicRNG::random() {
     }
 }
 
+const std::string& event_name(EventKind kind) {
+    static const std::array<std::string, static_cast<std::size_t>(EventKind::Count)> names = {
+        "start", "claim", "reinforce", "move", "conquer", "defeat", "victory", "adjudicated"};
+    return names[static_cast<std::size_t>(kind)];
+}
+
 Game::Game(World world_in, std::vector<Player> players_in, EventLogger logger,
            std::optional<std::uint32_t> seed)
-    : world(std::move(world_in)), players(std::move(players_in)), logger_(std::move(logger)) {
+    : world(std::move(world_in)), players(std::move(players_in)) {
+    set_logger(std::move(logger));
     if (seed.has_value()) {
         rng_.seed(seed.value());
     }
+    player_by_name_.reserve(players.size());
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        player_by_name_.emplace(players[i].name, i);
+    }
+    refresh();
 }
 
 Player* Game::find_player(const std::string& name) {
-    auto it = std::find_if(players.begin(), players.end(), [&](const Player& p) { return p.name == name; });
-    return it != players.end() ? &(*it) : nullptr;
+    auto it = player_by_name_.find(name);
+    return it != player_by_name_.end() ? &players[it->second] : nullptr;
 }
 
 Territory* Game::find_territory(const std::string& name) { return world.territory(name); }
 
-int Game::territory_count(const Player& player) const {
-    int count = 0;
-    for (const auto& [_, t] : world.territories) {
-        if (t->owner == &player) {
-            ++count;
-        }
-    }
-    return count;
-}
+int Game::territory_count(const Player& player) const { return owned_count_[player_index(player)]; }
 
 int Game::reinforcement_count(const Player& player) const {
     int base = std::max(territory_count(player) / 3, 3);
@@ -355,28 +482,14 @@ int Game::reinforcement_count(const Player& player) const {
 
 bool Game::claim(const std::string& player_name, const std::string& territory_name, int forces) {
     auto* player = find_player(player_name);
-    auto* territory_ptr = find_territory(territory_name);
-    if (!player || !territory_ptr) {
-        return false;
-    }
-    if (territory_ptr->owner && territory_ptr->owner != player) {
-        return false;
-    }
-    territory_ptr->owner = player;
-    territory_ptr->forces += forces;
-    emit("claim", {player->name, territory_ptr->name, forces});
-    return true;
+    auto* territory = find_territory(territory_name);
+    return player && territory && claim_at(*player, *territory, forces);
 }
 
 bool Game::reinforce(const std::string& player_name, const std::string& territory_name, int forces) {
     auto* player = find_player(player_name);
-    auto* territory_ptr = find_territory(territory_name);
-    if (!player || !territory_ptr || territory_ptr->owner != player || forces < 0) {
-        return false;
-    }
-    territory_ptr->forces += forces;
-    emit("reinforce", {player->name, territory_ptr->name, forces});
-    return true;
+    auto* territory = find_territory(territory_name);
+    return player && territory && reinforce_at(*player, *territory, forces);
 }
 
 bool Game::validate_move(const Territory& src, const Territory& dst, int forces) const {
@@ -388,16 +501,7 @@ bool Game::move(const std::string& player_name, const std::string& src_name,
     auto* player = find_player(player_name);
     auto* src = find_territory(src_name);
     auto* dst = find_territory(target_name);
-    if (!player || !src || !dst || src->owner != player || dst->owner != player) {
-        return false;
-    }
-    if (!validate_move(*src, *dst, forces)) {
-        return false;
-    }
-    src->forces -= forces;
-    dst->forces += forces;
-    emit("move", {player->name, src->name, dst->name, forces});
-    return true;
+    return player && src && dst && move_at(*player, *src, *dst, forces);
 }
 
 bool Game::resolve_combat(const std::string& src_name, const std::string& target_name,
@@ -405,76 +509,192 @@ bool Game::resolve_combat(const std::string& src_name, const std::string& target
                           const std::function<int(int)>& move_decider) {
     Territory* src = find_territory(src_name);
     Territory* dst = find_territory(target_name);
-    if (!src || !dst || src->owner == nullptr || src->owner == dst->owner ||
-        src->connect.count(dst) == 0) {
+    if (!src || !dst) {
         return false;
     }
+    if (rng_.mode() == PythonicRNG::Mode::StdMT) {
+        using StdPolicy =
+            GamePolicy<Validation::Checked, Emission::Legacy, PythonicRNG::Mode::StdMT>;
+        return combat_at<StdPolicy>(*src, *dst, attack_decider, move_decider);
+    }
+    return combat_at(*src, *dst, attack_decider, move_decider);
+}
 
-    int initial_atk = src->forces;
-    int initial_def = dst->forces;
-    int n_atk = initial_atk;
-    int n_def = initial_def;
-    auto should_attack = attack_decider ? attack_decider : [](int, int) { return true; };
-    auto decide_move = move_decider ? move_decider : [](int a) { return a - 1; };
-
-    while (n_atk > 1 && n_def > 0 && should_attack(n_atk, n_def)) {
-        int atk_dice = std::min(n_atk - 1, 3);
-        int def_dice = std::min(n_def, 2);
-        std::vector<int> atk_roll;
-        std::vector<int> def_roll;
-        for (int i = 0; i < atk_dice; ++i) {
-            atk_roll.push_back(rng_.randint(1, 6));
-        }
-        for (int i = 0; i < def_dice; ++i) {
-            def_roll.push_back(rng_.randint(1, 6));
-        }
-        std::sort(atk_roll.begin(), atk_roll.end(), std::greater<int>());
-        std::sort(def_roll.begin(), def_roll.end(), std::greater<int>());
-        for (size_t i = 0; i < std::min(atk_roll.size(), def_roll.size()); ++i) {
-            if (atk_roll[i] > def_roll[i]) {
-                --n_def;
-            } else {
-                --n_atk;
-            }
-        }
+void Game::set_logger(EventLogger logger, EventMask events) {
+    logger_ = std::move(logger);
+    events_ = logger_ ? events : kNoEvents;
+}
+
+void Game::reseed(std::uint32_t seed) { rng_.seed(seed); }
+
+void Game::reset(std::uint32_t seed) {
+    world.clear_board();
+    to_move_ = nullptr;
+    event_count_ = 0;
+    rng_.seed(seed);
+    refresh();
+}
+
+PythonicRNG& Game::rng() { return rng_; }
+
+void Game::victory(const std::string& player_name) {
+    ++event_count_;
+    if (wants(EventKind::Victory)) {
+        emit(EventKind::Victory, {player_name});
+    }
+}
+
+void Game::adjudicate(const std::string& player_name, int turns) {
+    ++event_count_;
+    if (wants(EventKind::Adjudicated)) {
+        emit(EventKind::Adjudicated, {player_name, turns});
+    }
+}
+
+void Game::rehash() {
+    hash_ = to_move_ != nullptr ? zobrist::side_key(static_cast<std::size_t>(to_move_ - players.data())) : 0;
+    for (const auto* territory : world.territory_list) {
+        hash_ ^= territory_key(*territory);
     }
+}
 
-    if (n_def == 0) {
-        int move = decide_move(n_atk);
-        int min_move = std::min(n_atk - 1, 3);
-        int max_move = n_atk - 1;
-        move = std::clamp(move, min_move, max_move);
-        src->forces = n_atk - move;
-        dst->forces = move;
-        Player* previous_owner = dst->owner;
-        dst->owner = src->owner;
-        emit("conquer",
-             {src->owner->name, previous_owner ? previous_owner->name : std::string(), src->name,
-              dst->name, std::make_pair(initial_atk, initial_def),
-              std::make_pair(src->forces, dst->forces)});
-        return true;
+void Game::set_to_move(const Player* player) {
+    if (to_move_ != nullptr) {
+        hash_ ^= zobrist::side_key(static_cast<std::size_t>(to_move_ - players.data()));
+    }
+    to_move_ = player;
+    if (to_move_ != nullptr) {
+        hash_ ^= zobrist::side_key(static_cast<std::size_t>(to_move_ - players.data()));
     }
+}
 
-    src->forces = n_atk;
-    dst->forces = n_def;
-    emit("defeat", {src->owner->name, dst->owner ? dst->owner->name : std::string(), src->name,
-                    dst->name, std::make_pair(initial_atk, initial_def),
-                    std::make_pair(src->forces, dst->forces)});
-    return false;
+std::uint64_t Game::territory_key(const Territory& territory) const {
+    std::size_t owner = territory.owner != nullptr
+                            ? static_cast<std::size_t>(territory.owner - players.data()) + 1
+                            : 0;
+    return zobrist::territory_key(territory.index, owner, territory.forces);
 }
 
-void Game::set_logger(EventLogger logger) { logger_ = std::move(logger); }
+void Game::set_territory(Territory& territory, Player* owner, int forces) {
+    hash_ ^= territory_key(territory);
+    Player* previous = territory.owner;
+    int previous_forces = territory.forces;
+    territory.owner = owner;
+    territory.forces = forces;
+    hash_ ^= territory_key(territory);
 
-void Game::reseed(std::uint32_t seed) { rng_.seed(seed); }
+    if (previous != owner) {
+        track_owner_change(territory, previous, previous_forces);
+    } else if (owner != nullptr && forces != previous_forces) {
+        int delta = forces - previous_forces;
+        for (auto i = world.adjacency_offsets[territory.index];
+             i < world.adjacency_offsets[territory.index + 1]; ++i) {
+            if (world.territory_list[world.adjacency[i]]->owner != owner) {
+                enemy_forces_[world.adjacency[i]] += delta;
+            }
+        }
+    }
+}
 
-PythonicRNG& Game::rng() { return rng_; }
+void Game::track_owner_change(Territory& territory, Player* previous, int previous_forces) {
+    const Player* owner = territory.owner;
+    if (previous != nullptr && --owned_count_[player_index(*previous)] == 0) {
+        --alive_players_;
+    }
+    if (owner != nullptr && owned_count_[player_index(*owner)]++ == 0) {
+        ++alive_players_;
+    }
+
+    int hostile = 0;
+    int enemy = 0;
+    for (auto i = world.adjacency_offsets[territory.index];
+         i < world.adjacency_offsets[territory.index + 1]; ++i) {
+        Territory& neighbour = *world.territory_list[world.adjacency[i]];
+        // How the neighbour sees this territory, before and after.
+        bool was_hostile = previous != nullptr && previous != neighbour.owner;
+        bool now_hostile = owner != nullptr && owner != neighbour.owner;
+        if (was_hostile) {
+            --hostile_neighbours_[neighbour.index];
+            enemy_forces_[neighbour.index] -= previous_forces;
+        }
+        if (now_hostile) {
+            ++hostile_neighbours_[neighbour.index];
+            enemy_forces_[neighbour.index] += territory.forces;
+        }
+        if (was_hostile != now_hostile) {
+            update_frontier(neighbour);
+        }
+        // How this territory sees the neighbour.
+        if (neighbour.owner != nullptr && neighbour.owner != owner) {
+            ++hostile;
+            enemy += neighbour.forces;
+        }
+    }
+    hostile_neighbours_[territory.index] = hostile;
+    enemy_forces_[territory.index] = enemy;
 
-void Game::victory(const std::string& player_name) { emit("victory", {player_name}); }
+    if (in_frontier_[territory.index] != 0) {
+        auto& old_frontier = frontier_[player_index(*previous)];
+        old_frontier.erase(std::find(old_frontier.begin(), old_frontier.end(), &territory));
+        in_frontier_[territory.index] = 0;
+    }
+    update_frontier(territory);
+}
 
-void Game::emit(const std::string& name, std::vector<EventValue> args) {
-    if (logger_) {
-        logger_({name, std::move(args)});
+void Game::update_frontier(Territory& territory) {
+    bool member = territory.owner != nullptr && hostile_neighbours_[territory.index] > 0;
+    if (member == (in_frontier_[territory.index] != 0)) {
+        return;
+    }
+    auto& list = frontier_[player_index(*territory.owner)];
+    auto by_index = [](const Territory* lhs, const Territory* rhs) { return lhs->index < rhs->index; };
+    auto it = std::lower_bound(list.begin(), list.end(), &territory, by_index);
+    if (member) {
+        list.insert(it, &territory);
+    } else {
+        list.erase(it);
     }
+    in_frontier_[territory.index] = member ? 1 : 0;
+}
+
+const std::vector<Territory*>& Game::frontier(const Player& player) const {
+    return frontier_[player_index(player)];
+}
+
+void Game::refresh() {
+    rehash();
+    std::size_t n = world.territory_list.size();
+    enemy_forces_.assign(n, 0);
+    hostile_neighbours_.assign(n, 0);
+    in_frontier_.assign(n, 0);
+    // Cleared in place so a reset keeps the lists' capacity.
+    frontier_.resize(players.size());
+    for (auto& list : frontier_) {
+        list.clear();
+    }
+    owned_count_.assign(players.size(), 0);
+    alive_players_ = 0;
+    for (auto* territory : world.territory_list) {
+        if (territory->owner != nullptr && owned_count_[player_index(*territory->owner)]++ == 0) {
+            ++alive_players_;
+        }
+        for (auto i = world.adjacency_offsets[territory->index];
+             i < world.adjacency_offsets[territory->index + 1]; ++i) {
+            const Territory* neighbour = world.territory_list[world.adjacency[i]];
+            if (neighbour->owner != nullptr && neighbour->owner != territory->owner) {
+                ++hostile_neighbours_[territory->index];
+                enemy_forces_[territory->index] += neighbour->forces;
+            }
+        }
+        if (territory->owner != nullptr && hostile_neighbours_[territory->index] > 0) {
+            frontier_[player_index(*territory->owner)].push_back(territory);
+            in_frontier_[territory->index] = 1;
+        }
+    }
+}
+
+void Game::emit(EventKind kind, std::vector<EventValue> args) {
+    logger_({kind, event_name(kind), std::move(args)});
 }
 
 }  // namespace pyrisk
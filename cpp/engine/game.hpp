@@ -1,12 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <iosfwd>
 #include <iterator>
 #include <memory>
 #include <optional>
 #include <random>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -28,11 +32,93 @@ public:
 };
 
 class Area;
+class Territory;
+
+// Which neighbours a NeighbourView yields, judged from the territory it
+// belongs to. Hostile counts unowned neighbours too; Enemy only those held
+// by another player.
+enum class Side { Any, Friendly, Hostile, Enemy };
+enum class Region { Any, SameArea, OtherArea };
+
+// A filtered range over a territory's neighbours that reads the adjacency
+// list in place. The filter is checked as an iterator advances, against the
+// owners at that moment.
+class NeighbourView {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Territory*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Territory* const*;
+        using reference = Territory* const&;
+
+        iterator() = default;
+        iterator(const Territory* from, pointer at, pointer end, Side side, Region region)
+            : from_(from), at_(at), end_(end), side_(side), region_(region) {
+            skip();
+        }
+
+        reference operator*() const { return *at_; }
+        iterator& operator++() {
+            ++at_;
+            skip();
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator before = *this;
+            ++*this;
+            return before;
+        }
+        bool operator==(const iterator& other) const { return at_ == other.at_; }
+        bool operator!=(const iterator& other) const { return at_ != other.at_; }
+
+    private:
+        void skip();
+
+        const Territory* from_{nullptr};
+        pointer at_{nullptr};
+        pointer end_{nullptr};
+        Side side_{Side::Any};
+        Region region_{Region::Any};
+    };
+
+    NeighbourView(const Territory* from, Side side, Region region)
+        : from_(from), side_(side), region_(region) {}
+
+    static bool accepts(const Territory* from, const Territory* to, Side side, Region region);
+
+    iterator begin() const;
+    iterator end() const;
+
+    bool empty() const { return begin() == end(); }
+    std::size_t count() const;
+    int forces() const;
+
+    template <typename Pred>
+    bool any_of(Pred pred) const {
+        for (auto* t : *this) {
+            if (pred(t)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const Territory* from_;
+    Side side_;
+    Region region_;
+};
 
 class Territory {
 public:
     Territory(std::string name, Area* area);
 
+    NeighbourView neighbours(Side side = Side::Any, Region region = Region::Any) const {
+        return NeighbourView(this, side, region);
+    }
+
     bool border() const;
     bool area_owned() const;
     bool area_border() const;
@@ -46,20 +132,101 @@ public:
     Player* owner{nullptr};
     int forces{0};
     std::unordered_set<Territory*> connect;
+    // The same neighbours in a flat array for the views. World::load()
+    // fills it in `connect` order, which some AIs' choices depend on.
+    std::vector<Territory*> neighbour_list;
     char ord{0};
+    std::size_t index{0};  // position in World::territory_list
+    // Position in name order, set by World::load(). Deterministic paths
+    // break ties with it instead of comparing names.
+    std::uint32_t name_rank{0};
 };
 
+inline bool NeighbourView::accepts(const Territory* from, const Territory* to, Side side,
+                                   Region region) {
+    switch (side) {
+        case Side::Any:
+            break;
+        case Side::Friendly:
+            if (to->owner != from->owner) {
+                return false;
+            }
+            break;
+        case Side::Hostile:
+            if (to->owner == from->owner) {
+                return false;
+            }
+            break;
+        case Side::Enemy:
+            if (to->owner == nullptr || to->owner == from->owner) {
+                return false;
+            }
+            break;
+    }
+    switch (region) {
+        case Region::Any:
+            return true;
+        case Region::SameArea:
+            return to->area == from->area;
+        case Region::OtherArea:
+            return to->area != from->area;
+    }
+    return true;
+}
+
+inline void NeighbourView::iterator::skip() {
+    while (at_ != end_ && !accepts(from_, *at_, side_, region_)) {
+        ++at_;
+    }
+}
+
+inline NeighbourView::iterator NeighbourView::begin() const {
+    const auto& list = from_->neighbour_list;
+    return iterator(from_, list.data(), list.data() + list.size(), side_, region_);
+}
+
+inline NeighbourView::iterator NeighbourView::end() const {
+    const auto& list = from_->neighbour_list;
+    auto* last = list.data() + list.size();
+    return iterator(from_, last, last, side_, region_);
+}
+
+inline std::size_t NeighbourView::count() const {
+    std::size_t n = 0;
+    for (auto it = begin(); it != end(); ++it) {
+        ++n;
+    }
+    return n;
+}
+
+inline int NeighbourView::forces() const {
+    int total = 0;
+    for (auto* t : *this) {
+        total += t->forces;
+    }
+    return total;
+}
+
+// Orders territories by name, as the Python engine does.
+inline bool by_name(const Territory* lhs, const Territory* rhs) {
+    return lhs->name_rank < rhs->name_rank;
+}
+
 class Area {
 public:
     Area(std::string name, int value);
 
     Player* owner() const;
     int forces() const;
-    std::unordered_set<Area*> adjacent() const;
+    // Areas with a territory bordering this one, in index order. Set by
+    // World::load().
+    const std::vector<Area*>& adjacent() const { return adjacent_areas; }
 
     std::string name;
     int value{0};
     std::unordered_set<Territory*> territories;
+    std::vector<Area*> adjacent_areas;
+    std::size_t index{0};  // position in World::area_list
 };
 
 class World {
@@ -70,19 +237,86 @@ public:
     Area* area(const std::string& a);
     void load(const std::unordered_map<std::string, AreaDefinition>& areas,
               const std::string& connections);
+    // Leaves every territory unowned and empty so a loaded world can be
+    // reused for another game; the topology is kept.
+    void clear_board();
+
+    // Topology queries answered from tables built by load(). Shortest paths
+    // count hops; ties are broken by territory index, not by pointer order.
+    // Hops from `from` to `to`, or -1 when `to` cannot be reached.
+    int distance(const Territory& from, const Territory& to) const;
+    // First step from `from` towards `to`; nullptr when already there or
+    // unreachable.
+    Territory* next_hop(const Territory& from, const Territory& to) const;
+    // Both ends included; empty when `to` cannot be reached.
+    std::vector<Territory*> route(const Territory& from, const Territory& to) const;
 
     std::unordered_map<std::string, std::unique_ptr<Territory>> territories;
     std::unordered_map<std::string, std::unique_ptr<Area>> areas;
+    // Dense views in map iteration order, filled by load().
+    std::vector<Territory*> territory_list;
+    std::vector<Area*> area_list;
+    // Territory i borders adjacency[adjacency_offsets[i] .. adjacency_offsets[i + 1]),
+    // as territory_list indices in ascending order.
+    std::vector<std::uint32_t> adjacency_offsets;
+    std::vector<std::uint32_t> adjacency;
+
+private:
+    static constexpr std::uint16_t kUnreachable = 0xFFFF;
+
+    void build_topology();
+
+    // n x n tables indexed [from * n + to].
+    std::vector<std::uint16_t> hops_;
+    std::vector<std::uint16_t> next_hop_;
+};
+
+enum class EventKind : std::uint8_t {
+    Start,
+    Claim,
+    Reinforce,
+    Move,
+    Conquer,
+    Defeat,
+    Victory,
+    Adjudicated,
+    Count
 };
 
+// Bit set of EventKinds that a logger or AI wants to receive.
+using EventMask = std::uint32_t;
+constexpr EventMask event_bit(EventKind kind) { return EventMask{1} << static_cast<unsigned>(kind); }
+constexpr EventMask kNoEvents = 0;
+constexpr EventMask kAllEvents = (EventMask{1} << static_cast<unsigned>(EventKind::Count)) - 1;
+
+const std::string& event_name(EventKind kind);
+
 using EventValue = std::variant<std::string, int, std::pair<int, int>>;
 struct Event {
+    EventKind kind;
     std::string name;
     std::vector<EventValue> args;
 };
 
 using EventLogger = std::function<void(const Event&)>;
 
+// A board action as pointers into the game, for observers that need no
+// strings. `player` acts and `other` defended; `count` is the forces
+// claimed, reinforced or moved, and a battle fills in the forces on both
+// territories before and after.
+struct BoardEvent {
+    EventKind kind;
+    const Player* player{nullptr};
+    const Player* other{nullptr};
+    const Territory* src{nullptr};
+    const Territory* dst{nullptr};
+    int count{0};
+    std::pair<int, int> before{};
+    std::pair<int, int> after{};
+};
+
+using BoardObserver = std::function<void(const BoardEvent&)>;
+
 class PythonicRNG {
 public:
     enum class Mode { PythonMT, StdMT };
@@ -92,15 +326,24 @@ public:
 
     void seed(std::uint32_t seed);
     void set_mode(Mode mode);
+    Mode mode() const { return mode_; }
     int randint(int low, int high_inclusive);
+    // randint() with the mode fixed at compile time and no argument checks,
+    // for inner loops; M must be mode().
+    template <Mode M>
+    int randint_as(int low, int high_inclusive);
     std::uint32_t randbits(int k);
     int randbelow(int n);
 
+    // Full generator state, for checkpoints.
+    void save(std::ostream& out) const;
+    void load(std::istream& in);
+
     template <typename Iterator>
     void shuffle(Iterator first, Iterator last);
 
 private:
-    void init_by_array(const std::vector<std::uint32_t>& key);
+    void init_by_array(const std::uint32_t* key, std::size_t key_length);
     void twist();
     std::uint32_t extract();
     double random();
@@ -114,6 +357,42 @@ private:
     std::mt19937 std_engine_{};
 };
 
+inline std::uint32_t PythonicRNG::extract() {
+    if (index_ >= kN) {
+        twist();
+    }
+    std::uint32_t y = state_[index_++];
+    y ^= (y >> 11);
+    y ^= (y << 7) & 0x9D2C5680UL;
+    y ^= (y << 15) & 0xEFC60000UL;
+    y ^= (y >> 18);
+    return y;
+}
+
+template <PythonicRNG::Mode M>
+int PythonicRNG::randint_as(int low, int high_inclusive) {
+    if constexpr (M == Mode::StdMT) {
+        std::uniform_int_distribution<int> dist(low, high_inclusive);
+        return dist(std_engine_);
+    } else {
+        // randbelow() on a single word, as randbits() draws it for k <= 32.
+        auto n = static_cast<std::uint32_t>(high_inclusive - low + 1);
+        if (n == 1) {
+            return low;
+        }
+        int k = 0;
+        for (auto temp = n; temp > 0; temp >>= 1) {
+            ++k;
+        }
+        while (true) {
+            std::uint32_t r = extract() >> (32 - k);
+            if (r < n) {
+                return low + static_cast<int>(r);
+            }
+        }
+    }
+}
+
 template <typename Iterator>
 void PythonicRNG::shuffle(Iterator first, Iterator last) {
     auto distance = static_cast<int>(std::distance(first, last));
@@ -123,6 +402,25 @@ void PythonicRNG::shuffle(Iterator first, Iterator last) {
     }
 }
 
+// Compile-time choices for Game's board actions. Checked actions verify
+// ownership, adjacency and counts and return false on an illegal request;
+// Unchecked ones trust a caller that has checked already. Emission levels
+// are cumulative: Typed calls the board observer, and Legacy also builds an
+// Event for the logger when wants() the kind. R must be the game's
+// rng().mode().
+enum class Validation { Checked, Unchecked };
+enum class Emission { None, Typed, Legacy };
+
+template <Validation V, Emission E, PythonicRNG::Mode R = PythonicRNG::Mode::PythonMT>
+struct GamePolicy {
+    static constexpr Validation validation = V;
+    static constexpr Emission emission = E;
+    static constexpr PythonicRNG::Mode rng = R;
+};
+
+// What the name-based actions use.
+using CheckedPolicy = GamePolicy<Validation::Checked, Emission::Legacy>;
+
 class Game {
 public:
     Game(World world, std::vector<Player> players,
@@ -131,7 +429,9 @@ public:
     Player* find_player(const std::string& name);
     Territory* find_territory(const std::string& name);
 
+    // O(1): territory counts are kept up to date by the board actions.
     int territory_count(const Player& player) const;
+    int alive_players() const { return alive_players_; }
     int reinforcement_count(const Player& player) const;
 
     bool claim(const std::string& player_name, const std::string& territory_name, int forces = 1);
@@ -140,23 +440,229 @@ public:
     bool move(const std::string& player_name, const std::string& src_name,
               const std::string& target_name, int forces);
     void victory(const std::string& player_name);
+    // Ends a game that hit its limits; `player_name` is the scorer's pick.
+    void adjudicate(const std::string& player_name, int turns);
 
     bool resolve_combat(const std::string& src_name, const std::string& target_name,
                         const std::function<bool(int, int)>& attack_decider = {},
                         const std::function<int(int)>& move_decider = {});
 
-    void set_logger(EventLogger logger);
+    // The board actions on players and territories already looked up,
+    // specialized by a GamePolicy. The name-based calls above use these with
+    // CheckedPolicy.
+    template <typename Policy = CheckedPolicy>
+    bool claim_at(Player& player, Territory& territory, int forces = 1);
+    template <typename Policy = CheckedPolicy>
+    bool reinforce_at(Player& player, Territory& territory, int forces);
+    template <typename Policy = CheckedPolicy>
+    bool move_at(Player& player, Territory& src, Territory& dst, int forces);
+    template <typename Policy = CheckedPolicy>
+    bool combat_at(Territory& src, Territory& dst,
+                   const std::function<bool(int, int)>& attack_decider = {},
+                   const std::function<int(int)>& move_decider = {});
+
+    // Receives every board action as a BoardEvent, whatever the logger's mask.
+    void set_observer(BoardObserver observer) { observer_ = std::move(observer); }
+    // The lowest emission level that loses nothing anyone asked for.
+    Emission emission() const {
+        if (events_ != kNoEvents) {
+            return Emission::Legacy;
+        }
+        return observer_ ? Emission::Typed : Emission::None;
+    }
+
+    // Only events in `events` are built and passed to `logger`.
+    void set_logger(EventLogger logger, EventMask events = kAllEvents);
+    bool wants(EventKind kind) const { return (events_ & event_bit(kind)) != 0; }
     void reseed(std::uint32_t seed);
+    // Empties the board, reseeds and zeroes the event count so the game can
+    // be played again. Players, world and logger are kept, and once the
+    // game has been played before nothing is allocated.
+    void reset(std::uint32_t seed);
     PythonicRNG& rng();
+    const PythonicRNG& rng() const { return rng_; }
+    // Board actions performed so far, counted even when no event is built.
+    std::size_t event_count() const { return event_count_; }
+    void set_event_count(std::size_t count) { event_count_ = count; }  // for checkpoints
+
+    // Zobrist hash of every territory's owner and forces bucket plus the
+    // side to move, kept up to date by claim, reinforce, move and
+    // resolve_combat. rehash() recomputes it from the board.
+    std::uint64_t hash() const { return hash_; }
+    void rehash();
+
+    // Also kept up to date by the board actions: a player's frontier is the
+    // territories it owns that border another player's (Territory::border()),
+    // in territory_list order; enemy forces are the summed forces on
+    // neighbours held by anyone other than the territory's owner.
+    const std::vector<Territory*>& frontier(const Player& player) const;
+    bool on_frontier(const Territory& territory) const { return in_frontier_[territory.index] != 0; }
+    int adjacent_enemy_forces(const Territory& territory) const {
+        return enemy_forces_[territory.index];
+    }
+
+    // Recomputes the hash and frontier tracking; code that edits territories
+    // directly must call it.
+    void refresh();
+    void set_to_move(const Player* player);
+    const Player* to_move() const { return to_move_; }
 
     World world;
     std::vector<Player> players;
 
 private:
-    void emit(const std::string& name, std::vector<EventValue> args);
+    void emit(EventKind kind, std::vector<EventValue> args);
+    template <typename Policy>
+    void notify(const BoardEvent& event) {
+        if constexpr (Policy::emission != Emission::None) {
+            if (observer_) {
+                observer_(event);
+            }
+        }
+    }
+    std::uint64_t territory_key(const Territory& territory) const;
+    void set_territory(Territory& territory, Player* owner, int forces);
+    void track_owner_change(Territory& territory, Player* previous, int previous_forces);
+    void update_frontier(Territory& territory);
+    std::size_t player_index(const Player& player) const {
+        return static_cast<std::size_t>(&player - players.data());
+    }
 
     EventLogger logger_;
+    BoardObserver observer_;
+    EventMask events_{kNoEvents};
+    std::size_t event_count_{0};
+    std::uint64_t hash_{0};
+    const Player* to_move_{nullptr};
+    std::unordered_map<std::string, std::size_t> player_by_name_;
+    std::vector<int> owned_count_;  // by player index
+    int alive_players_{0};
+    // Frontier tracking, by territory index and by player index.
+    std::vector<int> enemy_forces_;
+    std::vector<int> hostile_neighbours_;
+    std::vector<std::uint8_t> in_frontier_;
+    std::vector<std::vector<Territory*>> frontier_;
     PythonicRNG rng_;
 };
 
+template <typename Policy>
+bool Game::claim_at(Player& player, Territory& territory, int forces) {
+    if constexpr (Policy::validation == Validation::Checked) {
+        if (territory.owner && territory.owner != &player) {
+            return false;
+        }
+    }
+    set_territory(territory, &player, territory.forces + forces);
+    ++event_count_;
+    notify<Policy>({EventKind::Claim, &player, nullptr, nullptr, &territory, forces});
+    if constexpr (Policy::emission == Emission::Legacy) {
+        if (wants(EventKind::Claim)) {
+            emit(EventKind::Claim, {player.name, territory.name, forces});
+        }
+    }
+    return true;
+}
+
+template <typename Policy>
+bool Game::reinforce_at(Player& player, Territory& territory, int forces) {
+    if constexpr (Policy::validation == Validation::Checked) {
+        if (territory.owner != &player || forces < 0) {
+            return false;
+        }
+    }
+    set_territory(territory, &player, territory.forces + forces);
+    ++event_count_;
+    notify<Policy>({EventKind::Reinforce, &player, nullptr, nullptr, &territory, forces});
+    if constexpr (Policy::emission == Emission::Legacy) {
+        if (wants(EventKind::Reinforce)) {
+            emit(EventKind::Reinforce, {player.name, territory.name, forces});
+        }
+    }
+    return true;
+}
+
+template <typename Policy>
+bool Game::move_at(Player& player, Territory& src, Territory& dst, int forces) {
+    if constexpr (Policy::validation == Validation::Checked) {
+        if (src.owner != &player || dst.owner != &player || !validate_move(src, dst, forces)) {
+            return false;
+        }
+    }
+    set_territory(src, &player, src.forces - forces);
+    set_territory(dst, &player, dst.forces + forces);
+    ++event_count_;
+    notify<Policy>({EventKind::Move, &player, nullptr, &src, &dst, forces});
+    if constexpr (Policy::emission == Emission::Legacy) {
+        if (wants(EventKind::Move)) {
+            emit(EventKind::Move, {player.name, src.name, dst.name, forces});
+        }
+    }
+    return true;
+}
+
+template <typename Policy>
+bool Game::combat_at(Territory& src, Territory& dst,
+                     const std::function<bool(int, int)>& attack_decider,
+                     const std::function<int(int)>& move_decider) {
+    if constexpr (Policy::validation == Validation::Checked) {
+        if (src.owner == nullptr || src.owner == dst.owner || src.connect.count(&dst) == 0) {
+            return false;
+        }
+        if (rng_.mode() != Policy::rng) {
+            throw std::logic_error("combat policy does not match the RNG mode");
+        }
+    }
+
+    int initial_atk = src.forces;
+    int initial_def = dst.forces;
+    int n_atk = initial_atk;
+    int n_def = initial_def;
+    std::array<int, 3> atk_roll{};
+    std::array<int, 2> def_roll{};
+    while (n_atk > 1 && n_def > 0 && (!attack_decider || attack_decider(n_atk, n_def))) {
+        int atk_dice = std::min(n_atk - 1, 3);
+        int def_dice = std::min(n_def, 2);
+        for (int i = 0; i < atk_dice; ++i) {
+            atk_roll[i] = rng_.randint_as<Policy::rng>(1, 6);
+        }
+        for (int i = 0; i < def_dice; ++i) {
+            def_roll[i] = rng_.randint_as<Policy::rng>(1, 6);
+        }
+        std::sort(atk_roll.begin(), atk_roll.begin() + atk_dice, std::greater<int>());
+        std::sort(def_roll.begin(), def_roll.begin() + def_dice, std::greater<int>());
+        for (int i = 0; i < std::min(atk_dice, def_dice); ++i) {
+            if (atk_roll[i] > def_roll[i]) {
+                --n_def;
+            } else {
+                --n_atk;
+            }
+        }
+    }
+
+    Player* attacker = src.owner;
+    Player* defender = dst.owner;
+    bool conquered = n_def == 0;
+    if (conquered) {
+        int move = move_decider ? move_decider(n_atk) : n_atk - 1;
+        move = std::clamp(move, std::min(n_atk - 1, 3), n_atk - 1);
+        set_territory(src, attacker, n_atk - move);
+        set_territory(dst, attacker, move);
+    } else {
+        set_territory(src, attacker, n_atk);
+        set_territory(dst, defender, n_def);
+    }
+    ++event_count_;
+    EventKind kind = conquered ? EventKind::Conquer : EventKind::Defeat;
+    notify<Policy>({kind, attacker, defender, &src, &dst, 0, {initial_atk, initial_def},
+                    {src.forces, dst.forces}});
+    if constexpr (Policy::emission == Emission::Legacy) {
+        if (wants(kind)) {
+            emit(kind, {attacker->name, defender ? defender->name : std::string(), src.name,
+                        dst.name, std::make_pair(initial_atk, initial_def),
+                        std::make_pair(src.forces, dst.forces)});
+        }
+    }
+    return conquered;
+}
+
 }  // namespace pyrisk
@@ -0,0 +1,102 @@
+#include "jsonl_sink.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include <unistd.h>
+
+namespace pyrisk {
+
+void JsonlWriter::append_int(int value) {
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+void JsonlWriter::append_string(const std::string& value) {
+    buffer_ += '"';
+    const char* run = value.data();
+    const char* end = run + value.size();
+    for (const char* c = run; c != end; ++c) {
+        if (*c == '\\' || *c == '"') {
+            buffer_.append(run, static_cast<std::size_t>(c - run));
+            buffer_ += '\\';
+            run = c;
+        }
+    }
+    buffer_.append(run, static_cast<std::size_t>(end - run));
+    buffer_ += '"';
+}
+
+void JsonlWriter::append(const Event& event) {
+    buffer_.append("{\"event\":");
+    append_string(event.name);
+    buffer_.append(",\"args\":[");
+    for (std::size_t i = 0; i < event.args.size(); ++i) {
+        if (i > 0) {
+            buffer_ += ',';
+        }
+        std::visit(
+            [&](const auto& value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, std::string>) {
+                    append_string(value);
+                } else if constexpr (std::is_same_v<T, int>) {
+                    append_int(value);
+                } else if constexpr (std::is_same_v<T, std::pair<int, int>>) {
+                    buffer_ += '[';
+                    append_int(value.first);
+                    buffer_ += ',';
+                    append_int(value.second);
+                    buffer_ += ']';
+                }
+            },
+            event.args[i]);
+    }
+    buffer_.append("]}\n");
+}
+
+JsonlSink::JsonlSink(int fd, std::size_t block_size) : fd_(fd), block_size_(block_size) {
+    writer_.reserve(block_size_ * 2);
+}
+
+JsonlSink::~JsonlSink() {
+    try {
+        flush();
+    } catch (...) {
+    }
+}
+
+void JsonlSink::write(const Event& event) {
+    writer_.append(event);
+    if (writer_.size() >= block_size_) {
+        flush();
+    }
+}
+
+void JsonlSink::flush() {
+    const char* data = writer_.data();
+    std::size_t left = writer_.size();
+    while (left > 0) {
+        ssize_t written = ::write(fd_, data, left);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            writer_.clear();
+            throw std::runtime_error(std::string("JSONL write failed: ") + std::strerror(errno));
+        }
+        data += written;
+        left -= static_cast<std::size_t>(written);
+    }
+    writer_.clear();
+}
+
+EventLogger JsonlSink::logger() {
+    return [this](const Event& event) { write(event); };
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "game.hpp"
+
+namespace pyrisk {
+
+// Formats events as JSON lines into a reusable buffer. The output is
+// byte-identical to event_to_json() followed by a newline.
+class JsonlWriter {
+public:
+    void append(const Event& event);
+
+    const char* data() const { return buffer_.data(); }
+    std::size_t size() const { return buffer_.size(); }
+    const std::string& str() const { return buffer_; }
+    void clear() { buffer_.clear(); }
+    void reserve(std::size_t bytes) { buffer_.reserve(bytes); }
+
+private:
+    void append_int(int value);
+    void append_string(const std::string& value);
+
+    std::string buffer_;
+};
+
+// Buffered JSONL output to a file descriptor, written in large blocks.
+class JsonlSink {
+public:
+    static constexpr std::size_t kDefaultBlock = 1 << 16;
+
+    explicit JsonlSink(int fd, std::size_t block_size = kDefaultBlock);
+    ~JsonlSink();
+
+    JsonlSink(const JsonlSink&) = delete;
+    JsonlSink& operator=(const JsonlSink&) = delete;
+
+    void write(const Event& event);
+    void flush();
+
+    // The returned logger refers to this sink, which must outlive it.
+    EventLogger logger();
+
+private:
+    int fd_;
+    std::size_t block_size_;
+    JsonlWriter writer_;
+};
+
+}  // namespace pyrisk
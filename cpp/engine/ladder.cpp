@@ -0,0 +1,333 @@
+#include "ladder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "binary_io.hpp"
+#include "match.hpp"
+
+namespace pyrisk {
+namespace {
+
+constexpr char kMagic[4] = {'P', 'R', 'L', 'D'};
+constexpr std::uint64_t kVersion = 1;
+
+// The prior: this many virtual games, split evenly, against a player of
+// strength 1.
+constexpr double kPriorGames = 2.0;
+
+// Sweeps after each result; the fit is warm-started, so a few are plenty.
+constexpr std::size_t kResultSweeps = 4;
+constexpr std::size_t kFullSweeps = 1000;
+
+// Elo per unit of natural log-strength.
+const double kEloScale = 400.0 / std::log(10.0);
+
+}  // namespace
+
+Ladder::Ladder(std::vector<std::string> names, std::vector<GameDriver::AiFactory> factories,
+               ThreadPool& pool)
+    : names_(std::move(names)), factories_(std::move(factories)), pool_(pool) {
+    if (names_.size() != factories_.size()) {
+        throw std::invalid_argument("ladder needs one factory per name");
+    }
+    std::vector<std::string> sorted = names_;
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        throw std::invalid_argument("ladder names must be unique");
+    }
+    std::size_t n = names_.size();
+    strength_.assign(n, 1.0);
+    games_.assign(n * n, 0);
+    points_.assign(n * n, 0);
+    pending_.assign(n * n, 0);
+}
+
+std::size_t Ladder::run(const LadderConfig& config,
+                        const std::function<void(const Ladder&)>& checkpoint) {
+    std::size_t window = config.window > 0 ? config.window : 2 * std::max<std::size_t>(1, pool_.size());
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_ = 0;
+    error_ = nullptr;
+    std::size_t started = 0;
+    std::size_t saved_at = 0;
+
+    while (true) {
+        std::size_t first = 0;
+        std::size_t second = 0;
+        while (!error_ && started - finished_ < window && started < config.max_pairs &&
+               pick(config.target_sd, first, second)) {
+            pending_[at(first, second)] += 2;
+            pending_[at(second, first)] += 2;
+            auto seed = config.seed + static_cast<std::uint32_t>(pairs_++);
+            ++started;
+            pool_.submit([this, first, second, seed, limits = config.limits]() {
+                std::pair<int, int> points;
+                std::exception_ptr error;
+                try {
+                    points = play_pair(factories_[first], factories_[second], seed, limits);
+                } catch (const std::exception& failure) {
+                    error = std::make_exception_ptr(std::runtime_error(
+                        names_[first] + " vs " + names_[second] + " on seed " +
+                        std::to_string(seed) + ": " + failure.what()));
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                // Notify under the lock: once run() sees the last result it
+                // may return and the ladder go away.
+                std::lock_guard<std::mutex> guard(mutex_);
+                if (error) {
+                    pending_[at(first, second)] -= 2;
+                    pending_[at(second, first)] -= 2;
+                    if (!error_) {
+                        error_ = error;
+                    }
+                } else {
+                    record(first, second, points.first + points.second);
+                }
+                ++finished_;
+                finished_cv_.notify_one();
+            });
+        }
+        if (started == finished_) {
+            break;
+        }
+        std::size_t seen = finished_;
+        finished_cv_.wait(lock, [&]() { return finished_ != seen; });
+
+        if (checkpoint && config.checkpoint_every > 0 && !error_ &&
+            finished_ - saved_at >= config.checkpoint_every) {
+            saved_at = finished_;
+            // save() takes the lock itself; results that land meanwhile are
+            // simply in this checkpoint or the next.
+            lock.unlock();
+            checkpoint(*this);
+            lock.lock();
+        }
+    }
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    return 2 * finished_;
+}
+
+void Ladder::record(std::size_t i, std::size_t j, int points) {
+    games_[at(i, j)] += 2;
+    games_[at(j, i)] += 2;
+    pending_[at(i, j)] -= 2;
+    pending_[at(j, i)] -= 2;
+    points_[at(i, j)] += static_cast<std::uint32_t>(points);
+    points_[at(j, i)] += static_cast<std::uint32_t>(4 - points);
+    refit(kResultSweeps);
+}
+
+void Ladder::refit(std::size_t sweeps) {
+    std::size_t n = names_.size();
+    for (std::size_t sweep = 0; sweep < sweeps; ++sweep) {
+        double change = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            double wins = kPriorGames / 2;
+            double denominator = kPriorGames / (strength_[i] + 1.0);
+            for (std::size_t j = 0; j < n; ++j) {
+                if (games_[at(i, j)] == 0) {
+                    continue;
+                }
+                wins += points_[at(i, j)] / 2.0;
+                denominator += games_[at(i, j)] / (strength_[i] + strength_[j]);
+            }
+            double updated = wins / denominator;
+            change = std::max(change, std::abs(std::log(updated / strength_[i])));
+            strength_[i] = updated;
+        }
+        if (change < 1e-9) {
+            break;
+        }
+    }
+}
+
+double Ladder::win_probability(std::size_t i, std::size_t j) const {
+    return strength_[i] / (strength_[i] + strength_[j]);
+}
+
+double Ladder::information(std::size_t i, bool pending) const {
+    double p0 = strength_[i] / (strength_[i] + 1.0);
+    double total = kPriorGames * p0 * (1.0 - p0);
+    for (std::size_t j = 0; j < names_.size(); ++j) {
+        double games = games_[at(i, j)] + (pending ? pending_[at(i, j)] : 0);
+        if (games > 0) {
+            double p = win_probability(i, j);
+            total += games * p * (1.0 - p);
+        }
+    }
+    return total;
+}
+
+double Ladder::sd(double information) const {
+    return kEloScale / std::sqrt(information);
+}
+
+bool Ladder::pick(double target_sd, std::size_t& first, std::size_t& second) const {
+    std::size_t n = names_.size();
+    if (n < 2) {
+        return false;
+    }
+    double worst = target_sd;
+    bool found = false;
+    for (std::size_t i = 0; i < n; ++i) {
+        double value = sd(information(i, true));
+        if (value > worst) {
+            worst = value;
+            first = i;
+            found = true;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    // A game is most telling between players of like strength, and a
+    // pairing already played often adds little the rest of the pool does
+    // not already say.
+    double best = -1.0;
+    for (std::size_t j = 0; j < n; ++j) {
+        if (j == first) {
+            continue;
+        }
+        double p = win_probability(first, j);
+        double met = games_[at(first, j)] + pending_[at(first, j)];
+        double value = p * (1.0 - p) / std::sqrt(1.0 + met);
+        if (value > best) {
+            best = value;
+            second = j;
+        }
+    }
+    return true;
+}
+
+std::vector<LadderRating> Ladder::ratings() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::size_t n = names_.size();
+    std::vector<LadderRating> result(n);
+    double mean = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        result[i].name = names_[i];
+        result[i].elo = kEloScale * std::log(strength_[i]);
+        result[i].sd = sd(information(i, false));
+        for (std::size_t j = 0; j < n; ++j) {
+            result[i].games += games_[at(i, j)];
+        }
+        mean += result[i].elo / static_cast<double>(n);
+    }
+    for (auto& rating : result) {
+        rating.elo -= mean;
+    }
+    std::stable_sort(result.begin(), result.end(),
+                     [](const LadderRating& a, const LadderRating& b) { return a.elo > b.elo; });
+    return result;
+}
+
+std::size_t Ladder::games() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return std::accumulate(games_.begin(), games_.end(), std::size_t{0}) / 2;
+}
+
+std::size_t Ladder::round_robin_games(const std::vector<std::size_t>& players,
+                                      double target_sd) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::size_t n = names_.size();
+    std::vector<bool> included(n, false);
+    for (auto i : players) {
+        included.at(i) = true;
+    }
+    // Every pairing plays `per_pairing` games, so player i's information
+    // is the prior plus per_pairing times its summed p(1 - p).
+    double needed = (kEloScale / target_sd) * (kEloScale / target_sd);
+    double per_pairing = 0.0;
+    for (auto i : players) {
+        double p0 = strength_[i] / (strength_[i] + 1.0);
+        double prior = kPriorGames * p0 * (1.0 - p0);
+        double spread = 0.0;
+        for (std::size_t j = 0; j < n; ++j) {
+            if (j != i) {
+                double p = win_probability(i, j);
+                spread += p * (1.0 - p);
+            }
+        }
+        if (spread > 0.0) {
+            per_pairing = std::max(per_pairing, (needed - prior) / spread);
+        }
+    }
+    // Pairs of games, as the ladder plays them.
+    auto per = 2 * static_cast<std::size_t>(std::ceil(std::max(per_pairing, 0.0) / 2));
+    std::size_t pairings = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            pairings += included[i] || included[j];
+        }
+    }
+    return per * pairings;
+}
+
+void Ladder::save(std::ostream& out) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    out.write(kMagic, sizeof(kMagic));
+    write_varint(out, kVersion);
+    write_varint(out, names_.size());
+    for (const auto& name : names_) {
+        write_string(out, name);
+    }
+    for (std::size_t k = 0; k < games_.size(); ++k) {
+        write_varint(out, games_[k]);
+        write_varint(out, points_[k]);
+    }
+    write_varint(out, pairs_);
+}
+
+void Ladder::load(std::istream& in) {
+    char magic[sizeof(kMagic)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("not a ladder file");
+    }
+    if (read_varint(in) != kVersion) {
+        throw std::runtime_error("unsupported ladder file version");
+    }
+    std::unordered_map<std::string, std::size_t> index;
+    for (std::size_t i = 0; i < names_.size(); ++i) {
+        index.emplace(names_[i], i);
+    }
+    std::vector<std::size_t> slots(read_varint(in));
+    for (auto& slot : slots) {
+        auto name = read_string(in);
+        auto found = index.find(name);
+        if (found == index.end()) {
+            throw std::runtime_error("ladder file rates " + name + ", which is not in this ladder");
+        }
+        slot = found->second;
+    }
+    std::vector<std::uint32_t> games(games_.size(), 0);
+    std::vector<std::uint32_t> points(points_.size(), 0);
+    for (auto i : slots) {
+        for (auto j : slots) {
+            games[at(i, j)] = static_cast<std::uint32_t>(read_varint(in));
+            points[at(i, j)] = static_cast<std::uint32_t>(read_varint(in));
+        }
+    }
+    auto pairs = read_varint(in);
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    games_ = std::move(games);
+    points_ = std::move(points);
+    pairs_ = pairs;
+    std::fill(strength_.begin(), strength_.end(), 1.0);
+    refit(kFullSweeps);
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ai.hpp"
+#include "thread_pool.hpp"
+
+namespace pyrisk {
+
+struct LadderConfig {
+    double target_sd{30.0};        // stop once every rating is this sure, in Elo
+    std::size_t max_pairs{20000};  // per run()
+    std::size_t window{0};         // pairs in flight; 0 is twice the pool size
+    std::uint32_t seed{1};         // the ladder's k-th pair is played on seed + k
+    // The wall limit turns a runaway game into an error from run() rather
+    // than a ladder that never finishes.
+    GameLimits limits{1000, 0, std::chrono::seconds(60)};
+    std::size_t checkpoint_every{0};  // results between checkpoint calls; 0 never
+};
+
+struct LadderRating {
+    std::string name;
+    double elo{0.0};  // relative to the population mean
+    double sd{0.0};
+    std::size_t games{0};
+};
+
+// Ranks a population of AIs with a Bradley-Terry model fitted to every
+// head-to-head result. Games are seat-swapped pairs (see play_pair()) run
+// on `pool`. Each result refits the ratings as it arrives from a worker, and
+// the next pair goes to the least certain player against the opponent whose
+// game tells it most: one rated close by that it has met least. A player
+// added to a ranked ladder therefore plays mostly near its own level instead
+// of a full round robin.
+//
+// Ratings get a weak prior of one win and one loss against an average
+// player, so they stay finite before the first win or loss. Results are
+// taken in completion order, so with several pairs in flight the schedule,
+// and with it the ratings, can differ from run to run.
+class Ladder {
+public:
+    Ladder(std::vector<std::string> names, std::vector<GameDriver::AiFactory> factories,
+           ThreadPool& pool);
+
+    // Plays until every sd is under target_sd or max_pairs have been played,
+    // calling `checkpoint` every checkpoint_every results from the calling
+    // thread. Returns the games played. If a game throws, no more pairs are
+    // started and, once those in flight are in, run() throws
+    // std::runtime_error naming the pairing and seed; results recorded
+    // before that stay in the ladder.
+    std::size_t run(const LadderConfig& config,
+                    const std::function<void(const Ladder&)>& checkpoint = {});
+
+    // Strongest first.
+    std::vector<LadderRating> ratings() const;
+    std::size_t games() const;
+
+    // Games a round robin with the same count for every pairing would need
+    // to bring each player in `players` (by index) under `target_sd`, at
+    // the current ratings. Only pairings involving those players count.
+    std::size_t round_robin_games(const std::vector<std::size_t>& players, double target_sd) const;
+
+    // Results and the pair counter. load() keeps players the file does not
+    // know as new entrants and throws std::runtime_error if it names a
+    // player not in this ladder.
+    void save(std::ostream& out) const;
+    void load(std::istream& in);
+
+private:
+    std::size_t at(std::size_t i, std::size_t j) const { return i * names_.size() + j; }
+    void record(std::size_t i, std::size_t j, int points);
+    // Minorization-maximization sweeps, warm-started from the current
+    // strengths, until they settle or `sweeps` run out.
+    void refit(std::size_t sweeps);
+    double win_probability(std::size_t i, std::size_t j) const;
+    // Fisher information on player i's log-strength; with `pending`,
+    // games in flight count as played.
+    double information(std::size_t i, bool pending) const;
+    double sd(double information) const;
+    bool pick(double target_sd, std::size_t& first, std::size_t& second) const;
+
+    std::vector<std::string> names_;
+    std::vector<GameDriver::AiFactory> factories_;
+    ThreadPool& pool_;
+
+    mutable std::mutex mutex_;
+    std::vector<double> strength_;       // Bradley-Terry gamma
+    std::vector<std::uint32_t> games_;   // n * n, games between i and j
+    std::vector<std::uint32_t> points_;  // n * n, half points i took from j
+    std::vector<std::uint32_t> pending_; // n * n, games in flight
+    std::uint64_t pairs_{0};             // pairs started over the ladder's life
+
+    std::condition_variable finished_cv_;
+    std::size_t finished_{0};            // pairs recorded during run()
+    std::exception_ptr error_;
+};
+
+}  // namespace pyrisk
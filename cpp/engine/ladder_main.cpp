@@ -0,0 +1,168 @@
+// Rates a population of AIs on a Bradley-Terry ladder, spending games where
+// ratings are least certain. With --checkpoint the ladder resumes from the
+// file when it exists and is saved back as results arrive, so a new AI can
+// be added later and ranked against the rated pool in a few hundred games.
+// --variant adds a DeterministicAI with changed thresholds and may repeat.
+// A game still running after --max-seconds (default 60) stops the ladder
+// with an error; 0 lifts the limit.
+//
+//   pyrisk_ladder --ais DeterministicAI,BetterAI,AlAI --checkpoint ladder.bin
+//   pyrisk_ladder --ais DeterministicAI,BetterAI,AlAI --variant attack_ratio=1.4 --checkpoint ladder.bin
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ai_registry.hpp"
+#include "ladder.hpp"
+#include "tuning.hpp"
+
+int main(int argc, char** argv) {
+    using namespace pyrisk;
+
+    LadderConfig config;
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string ais = "DeterministicAI,BetterAI";
+    std::vector<std::string> variants;
+    const char* checkpoint_path = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--ais") == 0) {
+            ais = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--variant") == 0) {
+            variants.push_back(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--checkpoint") == 0) {
+            checkpoint_path = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--target-sd") == 0) {
+            config.target_sd = std::strtod(argv[i + 1], nullptr);
+        } else if (std::strcmp(argv[i], "--max-pairs") == 0) {
+            config.max_pairs = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--window") == 0) {
+            config.window = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            config.seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--max-turns") == 0) {
+            config.limits.max_turns = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--max-seconds") == 0) {
+            config.limits.max_wall = std::chrono::milliseconds(
+                static_cast<long>(1000.0 * std::strtod(argv[i + 1], nullptr)));
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            threads = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (!(config.target_sd > 0.0)) {
+        std::cerr << "--target-sd must be positive" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> names;
+    std::vector<GameDriver::AiFactory> factories;
+    for (std::size_t start = 0; start <= ais.size();) {
+        std::size_t end = std::min(ais.find(',', start), ais.size());
+        std::string ai = ais.substr(start, end - start);
+        start = end + 1;
+        auto factory = find_ai(ai);
+        if (!factory) {
+            std::cerr << "unknown AI " << ai << std::endl;
+            return 1;
+        }
+        names.push_back(ai);
+        factories.push_back(*factory);
+    }
+    for (const auto& variant : variants) {
+        DeterministicParams params;
+        try {
+            params = parse_deterministic_params(variant);
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        names.push_back("DeterministicAI(" + variant + ")");
+        factories.push_back([params](Player& player, Game& game) {
+            return std::make_unique<DeterministicAI>(player, game, params);
+        });
+    }
+
+    try {
+        ThreadPool pool(threads);
+        Ladder ladder(names, factories, pool);
+        if (checkpoint_path != nullptr) {
+            std::ifstream in(checkpoint_path, std::ios::binary);
+            if (in) {
+                ladder.load(in);
+                std::cout << "resumed " << ladder.games() << " games from " << checkpoint_path
+                          << std::endl;
+            }
+        }
+
+        // Written aside and renamed, so a crash never leaves half a file.
+        auto save = [&](const Ladder& current) {
+            std::string temporary = std::string(checkpoint_path) + ".tmp";
+            {
+                std::ofstream out(temporary, std::ios::binary);
+                current.save(out);
+                if (!out) {
+                    throw std::runtime_error("cannot write " + temporary);
+                }
+            }
+            if (std::rename(temporary.c_str(), checkpoint_path) != 0) {
+                throw std::runtime_error("cannot replace " + std::string(checkpoint_path));
+            }
+        };
+        std::function<void(const Ladder&)> checkpoint;
+        if (checkpoint_path != nullptr) {
+            checkpoint = save;
+            config.checkpoint_every = std::max<std::size_t>(1, 4 * pool.size());
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        std::size_t played = 0;
+        try {
+            played = ladder.run(config, checkpoint);
+        } catch (const std::exception&) {
+            // Keep the results that did come in.
+            if (checkpoint) {
+                save(ladder);
+            }
+            throw;
+        }
+        double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        if (checkpoint) {
+            save(ladder);
+        }
+
+        std::cout << std::left << std::setw(40) << "AI" << std::right << std::setw(8) << "elo"
+                  << std::setw(8) << "sd" << std::setw(8) << "games" << std::endl;
+        for (const auto& rating : ladder.ratings()) {
+            std::cout << std::left << std::setw(40) << rating.name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(8) << rating.elo << std::setw(8)
+                      << rating.sd << std::setw(8) << rating.games << std::endl;
+        }
+        std::cout << "played " << played << " games in " << std::setprecision(2) << seconds
+                  << "s, " << ladder.games() << " in the ladder" << std::endl;
+        // Without the ladder's results, ranking the pool again means a
+        // round robin of all of it.
+        std::vector<std::size_t> everyone(names.size());
+        std::iota(everyone.begin(), everyone.end(), std::size_t{0});
+        std::cout << "a round robin of all " << names.size() << " AIs to sd " << std::setprecision(1)
+                  << config.target_sd << " would need about "
+                  << ladder.round_robin_games(everyone, config.target_sd) << " games" << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+// Times main-phase turns in free-for-alls of growing size on one generated
+// map. Only turns a surviving player takes are timed; the seats of
+// eliminated players are skipped for free.
+//
+//   pyrisk_lobby_benchmark --players 2,4,8,16,32,64 --areas 64 --per-area 8
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ai_registry.hpp"
+#include "map_generator.hpp"
+
+int main(int argc, char** argv) {
+    using namespace pyrisk;
+    using Clock = std::chrono::steady_clock;
+
+    std::string counts = "2,4,8,16,32,64";
+    std::string ai_name = "StupidAI";
+    MapSpec spec{64, 8, 1};
+    std::size_t games = 5;
+    std::size_t max_turns = 5000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--players") == 0) {
+            counts = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--ai") == 0) {
+            ai_name = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--areas") == 0) {
+            spec.areas = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--per-area") == 0) {
+            spec.territories_per_area = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--map-seed") == 0) {
+            spec.seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--games") == 0) {
+            games = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--max-turns") == 0) {
+            max_turns = std::strtoul(argv[i + 1], nullptr, 10);
+        } else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    auto factory = find_ai(ai_name);
+    if (!factory) {
+        std::cerr << "unknown AI " << ai_name << std::endl;
+        return 1;
+    }
+
+    GeneratedMap map;
+    try {
+        map = generate_map(spec);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    std::cout << "map: " << spec.areas << " areas x " << spec.territories_per_area
+              << " territories, " << ai_name << ", " << games << " games per lobby" << std::endl;
+    std::cout << std::setw(8) << "players" << std::setw(10) << "played" << std::setw(10) << "turns"
+              << std::setw(12) << "setup_ms" << std::setw(14) << "ns_per_turn" << std::endl;
+
+    for (std::size_t start = 0; start <= counts.size();) {
+        std::size_t end = std::min(counts.find(',', start), counts.size());
+        std::size_t players = std::strtoul(counts.substr(start, end - start).c_str(), nullptr, 10);
+        start = end + 1;
+        if (players < 2) {
+            continue;
+        }
+        std::vector<std::string> names;
+        for (std::size_t i = 0; i < players; ++i) {
+            names.push_back("P" + std::to_string(i + 1));
+        }
+        std::vector<GameDriver::AiFactory> factories(players, *factory);
+
+        std::size_t played = 0;
+        std::size_t turns = 0;
+        double setup_seconds = 0.0;
+        double turn_seconds = 0.0;
+        for (std::size_t g = 0; g < games; ++g) {
+            World world;
+            world.load(map.areas, map.connections);
+            GameDriver driver(std::move(world), names, factories, /*deal=*/true, {},
+                              static_cast<std::uint32_t>(g));
+            driver.set_logger_events(kNoEvents);
+            driver.set_limits({max_turns, 0});
+
+            // The clock restarts at each hook call, so setup is the time up
+            // to the first turn and the rest is spent in turns.
+            auto started = Clock::now();
+            auto last = started;
+            bool first = true;
+            driver.set_turn_hook([&](GameDriver&) {
+                auto now = Clock::now();
+                if (first) {
+                    first = false;
+                    setup_seconds += std::chrono::duration<double>(now - started).count();
+                } else {
+                    turn_seconds += std::chrono::duration<double>(now - last).count();
+                    ++played;
+                }
+                last = now;
+                return true;
+            });
+            driver.play();
+            turns += driver.result().turns;
+        }
+        std::cout << std::setw(8) << players << std::setw(10) << played << std::setw(10) << turns
+                  << std::setw(12) << std::fixed << std::setprecision(2)
+                  << setup_seconds * 1e3 / static_cast<double>(games) << std::setw(14)
+                  << std::setprecision(0)
+                  << (played > 0 ? turn_seconds * 1e9 / static_cast<double>(played) : 0.0)
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "map_generator.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "game.hpp"
+
+namespace pyrisk {
+namespace {
+
+std::string territory_name(std::size_t area, std::size_t index) {
+    return "A" + std::to_string(area) + "-T" + std::to_string(index);
+}
+
+}  // namespace
+
+GeneratedMap generate_map(const MapSpec& spec) {
+    if (spec.areas == 0 || spec.territories_per_area < 2) {
+        throw std::invalid_argument("a map needs at least one area of two territories");
+    }
+    PythonicRNG rng(spec.seed);
+    std::size_t size = spec.territories_per_area;
+    auto columns = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(spec.areas))));
+
+    GeneratedMap map;
+    std::string& out = map.connections;
+    auto link = [&](const std::string& from, const std::string& to) {
+        out += from;
+        out += "--";
+        out += to;
+        out += '\n';
+    };
+    auto pick = [&]() { return static_cast<std::size_t>(rng.randbelow(static_cast<int>(size))); };
+
+    for (std::size_t a = 0; a < spec.areas; ++a) {
+        AreaDefinition def;
+        def.territories.reserve(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            def.territories.push_back(territory_name(a, i));
+        }
+
+        // A ring, so every territory has two neighbours at home.
+        for (std::size_t i = 0; i + 1 < size; ++i) {
+            link(def.territories[i], def.territories[i + 1]);
+        }
+        if (size > 2) {
+            link(def.territories[size - 1], def.territories[0]);
+        }
+        // Chords skip at least one ring neighbour (size >= 4 here).
+        for (std::size_t chord = 0; chord < size / 4; ++chord) {
+            std::size_t from = pick();
+            std::size_t to = (from + 2 + pick() % (size - 3)) % size;
+            link(def.territories[from], def.territories[to]);
+        }
+
+        // Border links out of the area are what it costs to hold.
+        std::size_t borders = 0;
+        if ((a + 1) % columns != 0 && a + 1 < spec.areas) {
+            link(territory_name(a, pick()), territory_name(a + 1, pick()));
+            ++borders;
+        }
+        if (a + columns < spec.areas) {
+            link(territory_name(a, pick()), territory_name(a + columns, pick()));
+            ++borders;
+        }
+        borders += (a % columns != 0 ? 1 : 0) + (a >= columns ? 1 : 0);
+        def.value = static_cast<int>((size + borders) / 3);
+        map.areas.emplace("Area " + std::to_string(a), std::move(def));
+    }
+    return map;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "world_data.hpp"
+
+namespace pyrisk {
+
+// A synthetic map: `areas` continents laid out on a grid, each a ring of
+// `territories_per_area` territories with a few random chords, joined to
+// the continents to their right and below by one border link each.
+struct MapSpec {
+    std::size_t areas{16};
+    std::size_t territories_per_area{8};
+    std::uint32_t seed{0};
+};
+
+// Area definitions and connection lines in the World::load() format.
+struct GeneratedMap {
+    std::unordered_map<std::string, AreaDefinition> areas;
+    std::string connections;
+};
+
+// The same spec always gives the same map.
+GeneratedMap generate_map(const MapSpec& spec);
+
+}  // namespace pyrisk
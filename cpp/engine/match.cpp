@@ -0,0 +1,169 @@
+#include "match.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "world_data.hpp"
+
+namespace pyrisk {
+namespace {
+
+double expected_score(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+// A virtual pair spread over the near-even outcomes, 1 to 3 half points,
+// added to the pentanomial counts for the variance only. Real pairs soon
+// swamp it, but it keeps the variance honest while every pair has landed
+// in one bucket, as when an AI meets itself and every pair splits 2-2.
+constexpr std::array<double, 5> kPriorPairs = {0.0, 1.0 / 3, 1.0 / 3, 1.0 / 3, 0.0};
+
+// Upper-tail normal quantile: the z with P(Z > z) = p.
+double normal_quantile(double p) {
+    double low = -10.0;
+    double high = 10.0;
+    for (int i = 0; i < 100; ++i) {
+        double mid = (low + high) / 2;
+        if (0.5 * std::erfc(mid / std::sqrt(2.0)) > p) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return (low + high) / 2;
+}
+
+int play_game(const GameDriver::AiFactory& first, const GameDriver::AiFactory& second,
+              std::uint32_t seed, bool swapped, GameLimits limits) {
+    // The names stay put so the seed shuffles the same turn order both
+    // times; only which AI sits behind each name changes.
+    std::vector<std::string> names = {"P1", "P2"};
+    std::vector<GameDriver::AiFactory> factories = {first, second};
+    if (swapped) {
+        std::swap(factories[0], factories[1]);
+    }
+    World world;
+    world.load(kAreas, kConnectionData);
+    GameDriver driver(std::move(world), names, factories, /*deal=*/false, {}, seed);
+    driver.set_logger_events(kNoEvents);
+    driver.set_limits(limits);
+    std::string winner = driver.play();
+    if (winner.empty()) {
+        return 1;
+    }
+    return (winner == names[0]) != swapped ? 2 : 0;
+}
+
+}  // namespace
+
+const char* verdict_name(MatchVerdict verdict) {
+    switch (verdict) {
+        case MatchVerdict::H0:
+            return "H0";
+        case MatchVerdict::H1:
+            return "H1";
+        case MatchVerdict::Inconclusive:
+            return "inconclusive";
+    }
+    return "?";
+}
+
+std::pair<int, int> play_pair(const GameDriver::AiFactory& first,
+                              const GameDriver::AiFactory& second, std::uint32_t seed,
+                              GameLimits limits) {
+    return {play_game(first, second, seed, false, limits),
+            play_game(first, second, seed, true, limits)};
+}
+
+MatchRunner::MatchRunner(GameDriver::AiFactory first, GameDriver::AiFactory second,
+                         ThreadPool& pool)
+    : first_(std::move(first)), second_(std::move(second)), pool_(pool) {}
+
+MatchResult MatchRunner::run(const MatchConfig& config) const {
+    if (!(config.elo1 > config.elo0) || config.alpha <= 0.0 || config.alpha >= 1.0 ||
+        config.beta <= 0.0 || config.beta >= 1.0) {
+        throw std::invalid_argument("a match needs elo1 > elo0 and error rates in (0, 1)");
+    }
+    MatchResult result;
+    result.lower = std::log(config.beta / (1.0 - config.alpha));
+    result.upper = std::log((1.0 - config.beta) / config.alpha);
+    double s0 = expected_score(config.elo0);
+    double s1 = expected_score(config.elo1);
+    std::size_t batch = std::max<std::size_t>(1, config.batch);
+
+    // Pair scores are tested as a normal approximation to the generalized
+    // SPRT: mean and variance come from the pentanomial counts, which keeps
+    // the correlation between the two games of a pair. The variance also
+    // counts kPriorPairs.
+    double mean = 0.5;
+    double variance = 0.0;
+    auto update = [&]() {
+        double n = static_cast<double>(result.pairs);
+        double sum = 0.0;
+        double prior_sum = 0.0;
+        double prior_squares = 0.0;
+        for (std::size_t points = 0; points < result.pentanomial.size(); ++points) {
+            double x = static_cast<double>(points) / 4.0;
+            double count = static_cast<double>(result.pentanomial[points]);
+            sum += count * x;
+            prior_sum += (count + kPriorPairs[points]) * x;
+            prior_squares += (count + kPriorPairs[points]) * x * x;
+        }
+        mean = sum / n;
+        double prior_mean = prior_sum / (n + 1.0);
+        variance = prior_squares / (n + 1.0) - prior_mean * prior_mean;
+        result.llr = n * (s1 - s0) * (2 * mean - s0 - s1) / (2 * variance);
+    };
+
+    std::size_t next = 0;
+    while (next < config.max_pairs) {
+        std::size_t end = std::min(config.max_pairs, next + batch);
+        std::vector<std::future<std::pair<int, int>>> pending;
+        pending.reserve(end - next);
+        for (std::size_t i = next; i < end; ++i) {
+            auto seed = config.seed + static_cast<std::uint32_t>(i);
+            pending.push_back(
+                pool_.submit([this, seed, &config]() {
+                    return play_pair(first_, second_, seed, config.limits);
+                }));
+        }
+        for (auto& future : pending) {
+            auto [home, away] = future.get();
+            for (int points : {home, away}) {
+                ++(points == 2 ? result.wins : points == 0 ? result.losses : result.draws);
+            }
+            ++result.pentanomial[static_cast<std::size_t>(home + away)];
+            ++result.pairs;
+        }
+        next = end;
+        update();
+        if (result.llr >= result.upper) {
+            result.verdict = MatchVerdict::H1;
+            break;
+        }
+        if (result.llr <= result.lower) {
+            result.verdict = MatchVerdict::H0;
+            break;
+        }
+    }
+
+    result.score = mean;
+    if (mean > 0.0 && mean < 1.0) {
+        result.elo = -400.0 * std::log10(1.0 / mean - 1.0);
+    } else {
+        double inf = std::numeric_limits<double>::infinity();
+        result.elo = mean >= 1.0 ? inf : -inf;
+    }
+    double z = normal_quantile(config.alpha) + normal_quantile(config.beta);
+    double fixed_pairs = std::ceil(variance * z * z / ((s1 - s0) * (s1 - s0)));
+    result.fixed_games = 2 * static_cast<std::size_t>(fixed_pairs);
+    return result;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "ai.hpp"
+#include "thread_pool.hpp"
+
+namespace pyrisk {
+
+// A sequential probability ratio test of H0: "first is elo0 stronger than
+// second" against H1: "first is elo1 stronger", with error rates alpha
+// (accepting H1 when H0 holds) and beta (the other way round).
+struct MatchConfig {
+    double elo0{0.0};
+    double elo1{20.0};
+    double alpha{0.05};
+    double beta{0.05};
+    std::size_t batch{32};         // pairs between stopping checks
+    std::size_t max_pairs{10000};  // give up undecided after this many
+    std::uint32_t seed{1};         // pair i is played on seed + i
+    GameLimits limits{1000, 0};
+};
+
+enum class MatchVerdict { H0, H1, Inconclusive };
+
+struct MatchResult {
+    std::size_t pairs{0};
+    std::size_t wins{0};    // games, from the first AI's side
+    std::size_t losses{0};
+    std::size_t draws{0};   // no winner within the limits
+    // Pairs by the first AI's points over both games, in half points: 0..4.
+    std::array<std::size_t, 5> pentanomial{};
+    double score{0.5};      // first AI's mean points per game
+    double elo{0.0};        // logistic Elo difference the score implies
+    double llr{0.0};
+    double lower{0.0};      // accept H0 at or below
+    double upper{0.0};      // accept H1 at or above
+    MatchVerdict verdict{MatchVerdict::Inconclusive};
+    // Games a fixed-length test with the same error rates would need, given
+    // the spread of pair scores seen here.
+    std::size_t fixed_games{0};
+
+    std::size_t games() const { return pairs * 2; }
+};
+
+// Head-to-head matches between two AIs on the classic map. Each pair plays
+// one seed twice with the seats swapped, which cancels most of the luck of
+// the deal and of moving first. Pairs run in batches on `pool` and the test
+// is only checked between batches, so with AIs that replay exactly from
+// their seed the result does not depend on the pool size.
+class MatchRunner {
+public:
+    MatchRunner(GameDriver::AiFactory first, GameDriver::AiFactory second, ThreadPool& pool);
+
+    MatchResult run(const MatchConfig& config) const;
+
+private:
+    GameDriver::AiFactory first_;
+    GameDriver::AiFactory second_;
+    ThreadPool& pool_;
+};
+
+const char* verdict_name(MatchVerdict verdict);
+
+// Plays `seed` twice on the classic map, the second time with the seats
+// swapped, and returns the first AI's points from each game in half
+// points: 2 for a win, 1 for a draw.
+std::pair<int, int> play_pair(const GameDriver::AiFactory& first,
+                              const GameDriver::AiFactory& second, std::uint32_t seed,
+                              GameLimits limits);
+
+}  // namespace pyrisk
@@ -0,0 +1,130 @@
+// Decides whether one AI is stronger than another with a sequential test on
+// seat-swapped game pairs, stopping as soon as the error bounds are met.
+// --first-params plays a DeterministicAI with changed thresholds as the
+// first AI, for checking a tweak against the defaults.
+//
+//   pyrisk_match --first BetterAI --second StupidAI --elo0 0 --elo1 20
+//   pyrisk_match --first-params attack_ratio=1.4,move_cap=5 --second DeterministicAI
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ai_registry.hpp"
+#include "match.hpp"
+#include "tuning.hpp"
+
+int main(int argc, char** argv) {
+    using namespace pyrisk;
+
+    MatchConfig config;
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string first_name = "DeterministicAI";
+    std::string second_name = "DeterministicAI";
+    const char* first_params = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--first") == 0) {
+            first_name = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--second") == 0) {
+            second_name = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--first-params") == 0) {
+            first_params = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--elo0") == 0) {
+            config.elo0 = std::strtod(argv[i + 1], nullptr);
+        } else if (std::strcmp(argv[i], "--elo1") == 0) {
+            config.elo1 = std::strtod(argv[i + 1], nullptr);
+        } else if (std::strcmp(argv[i], "--alpha") == 0) {
+            config.alpha = std::strtod(argv[i + 1], nullptr);
+        } else if (std::strcmp(argv[i], "--beta") == 0) {
+            config.beta = std::strtod(argv[i + 1], nullptr);
+        } else if (std::strcmp(argv[i], "--batch") == 0) {
+            config.batch = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--max-pairs") == 0) {
+            config.max_pairs = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            config.seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--max-turns") == 0) {
+            config.limits.max_turns = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            threads = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    GameDriver::AiFactory first;
+    if (first_params != nullptr) {
+        DeterministicParams params;
+        try {
+            params = parse_deterministic_params(first_params);
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        first_name = std::string("DeterministicAI(") + first_params + ")";
+        first = [params](Player& player, Game& game) {
+            return std::make_unique<DeterministicAI>(player, game, params);
+        };
+    } else if (auto factory = find_ai(first_name)) {
+        first = *factory;
+    } else {
+        std::cerr << "unknown AI " << first_name << std::endl;
+        return 1;
+    }
+    auto second = find_ai(second_name);
+    if (!second) {
+        std::cerr << "unknown AI " << second_name << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    MatchRunner runner(first, *second, pool);
+    MatchResult result;
+    auto started = std::chrono::steady_clock::now();
+    try {
+        result = runner.run(config);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::cout << first_name << " vs " << second_name << ": elo0=" << config.elo0
+              << " elo1=" << config.elo1 << " alpha=" << config.alpha << " beta=" << config.beta
+              << std::endl;
+    std::cout << "verdict " << verdict_name(result.verdict) << " after " << result.games()
+              << " games (" << result.pairs << " pairs) in " << std::fixed << std::setprecision(2)
+              << seconds << "s" << std::endl;
+    std::cout << "wins=" << result.wins << " losses=" << result.losses << " draws=" << result.draws
+              << " pairs[0..4 half points]=";
+    for (std::size_t k = 0; k < result.pentanomial.size(); ++k) {
+        std::cout << (k ? "," : "") << result.pentanomial[k];
+    }
+    std::cout << std::endl;
+    std::cout << "score=" << std::setprecision(4) << result.score << " elo=" << std::setprecision(1)
+              << result.elo << " llr=" << std::setprecision(3) << result.llr << " bounds=["
+              << result.lower << ", " << result.upper << "]" << std::endl;
+    // Pair scores with no spread say nothing about how long a fixed test
+    // would run.
+    if (result.pentanomial[2] == result.pairs) {
+        std::cout << "every pair split its points: the AIs play alike from either seat" << std::endl;
+        return 0;
+    }
+    std::cout << "fixed-length test with the same error rates: " << result.fixed_games
+              << " games";
+    if (result.fixed_games > 0) {
+        std::cout << " (sequential used " << std::setprecision(0)
+                  << 100.0 * static_cast<double>(result.games()) /
+                         static_cast<double>(result.fixed_games)
+                  << "%)";
+    }
+    std::cout << std::endl;
+    return 0;
+}
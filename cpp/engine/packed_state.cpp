@@ -0,0 +1,189 @@
+#include "packed_state.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace pyrisk {
+namespace {
+
+constexpr std::size_t kNibblePlayers = 15;
+
+void put_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+class Reader {
+public:
+    Reader(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint8_t byte = this->byte();
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("malformed varint in packed state");
+    }
+
+    std::uint8_t byte() {
+        if (pos_ == size_) {
+            throw std::runtime_error("truncated packed state");
+        }
+        return data_[pos_++];
+    }
+
+    std::size_t pos() const { return pos_; }
+
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t pos_{0};
+};
+
+struct Decoded {
+    std::vector<std::size_t> owners;
+    std::vector<int> forces;
+    TurnState turn;
+    std::size_t length{0};
+};
+
+// Decodes without touching the game, so a malformed state changes nothing.
+Decoded decode(const std::uint8_t* data, std::size_t size, const Game& game) {
+    Reader in(data, size);
+    const auto& territories = game.world.territory_list;
+    std::size_t players = game.players.size();
+    if (in.varint() != territories.size() || in.varint() != players) {
+        throw std::runtime_error("packed state does not match this game");
+    }
+
+    Decoded out;
+    auto& owners = out.owners;
+    owners.resize(territories.size());
+    if (players <= kNibblePlayers) {
+        for (std::size_t i = 0; i < territories.size(); i += 2) {
+            std::uint8_t byte = in.byte();
+            owners[i] = byte & 0x0F;
+            if (i + 1 < territories.size()) {
+                owners[i + 1] = byte >> 4;
+            }
+        }
+    } else {
+        for (auto& owner : owners) {
+            std::uint64_t code = in.varint();
+            owner = code > players ? players + 1 : static_cast<std::size_t>(code);
+        }
+    }
+    for (auto owner : owners) {
+        if (owner > players) {
+            throw std::runtime_error("packed state names an unknown player");
+        }
+    }
+    out.forces.resize(territories.size());
+    for (auto& count : out.forces) {
+        std::uint64_t value = in.varint();
+        if (value > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+            throw std::runtime_error("packed state forces out of range");
+        }
+        count = static_cast<int>(value);
+    }
+
+    auto& decoded = out.turn;
+    decoded.turn = static_cast<std::size_t>(in.varint());
+    std::uint64_t seats = in.varint();
+    if (seats > players) {
+        throw std::runtime_error("packed state has more seats than players");
+    }
+    decoded.seat_order.resize(static_cast<std::size_t>(seats));
+    for (auto& seat : decoded.seat_order) {
+        seat = static_cast<std::size_t>(in.varint());
+        if (seat >= players) {
+            throw std::runtime_error("packed state names an unknown player");
+        }
+    }
+
+    out.length = in.pos();
+    return out;
+}
+
+void commit(Decoded&& decoded, Game& game, TurnState& turn) {
+    auto& territories = game.world.territory_list;
+    for (std::size_t i = 0; i < territories.size(); ++i) {
+        std::size_t owner = decoded.owners[i];
+        territories[i]->owner = owner == 0 ? nullptr : &game.players[owner - 1];
+        territories[i]->forces = decoded.forces[i];
+    }
+    turn = std::move(decoded.turn);
+    const auto& seats = turn.seat_order;
+    game.set_to_move(seats.empty() ? nullptr : &game.players[seats[turn.turn % seats.size()]]);
+    game.refresh();
+}
+
+}  // namespace
+
+void pack_state(const Game& game, const TurnState& turn, std::vector<std::uint8_t>& out) {
+    const auto& territories = game.world.territory_list;
+    std::size_t players = game.players.size();
+    put_varint(out, territories.size());
+    put_varint(out, players);
+
+    auto owner_code = [&](const Territory* t) -> std::size_t {
+        return t->owner == nullptr ? 0 : static_cast<std::size_t>(t->owner - game.players.data()) + 1;
+    };
+    if (players <= kNibblePlayers) {
+        for (std::size_t i = 0; i < territories.size(); i += 2) {
+            std::size_t low = owner_code(territories[i]);
+            std::size_t high = i + 1 < territories.size() ? owner_code(territories[i + 1]) : 0;
+            out.push_back(static_cast<std::uint8_t>(low | (high << 4)));
+        }
+    } else {
+        for (const auto* t : territories) {
+            put_varint(out, owner_code(t));
+        }
+    }
+    for (const auto* t : territories) {
+        put_varint(out, static_cast<std::uint64_t>(t->forces));
+    }
+
+    put_varint(out, turn.turn);
+    put_varint(out, turn.seat_order.size());
+    for (auto seat : turn.seat_order) {
+        put_varint(out, seat);
+    }
+}
+
+std::size_t unpack_state(const std::uint8_t* data, std::size_t size, Game& game, TurnState& turn) {
+    Decoded decoded = decode(data, size, game);
+    std::size_t length = decoded.length;
+    commit(std::move(decoded), game, turn);
+    return length;
+}
+
+PackedState::PackedState(const Game& game, const TurnState& turn) {
+    pack_state(game, turn, bytes_);
+    // States are kept in bulk; don't carry the growth slack.
+    bytes_.shrink_to_fit();
+}
+
+void PackedState::apply(Game& game, TurnState& turn) const {
+    Decoded decoded = decode(bytes_.data(), bytes_.size(), game);
+    if (decoded.length != bytes_.size()) {
+        throw std::runtime_error("trailing bytes after packed state");
+    }
+    commit(std::move(decoded), game, turn);
+}
+
+PackedState PackedState::from_bytes(std::vector<std::uint8_t> bytes) {
+    PackedState state;
+    state.bytes_ = std::move(bytes);
+    return state;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game.hpp"
+
+namespace pyrisk {
+
+// Where play stands apart from the board: the driver's turn counter and the
+// seat order as Game::players indices.
+struct TurnState {
+    std::size_t turn{0};
+    std::vector<std::size_t> seat_order;
+
+    bool operator==(const TurnState& other) const {
+        return turn == other.turn && seat_order == other.seat_order;
+    }
+};
+
+// A position as a short byte string. After a header with the territory and
+// player counts come the owners in World::territory_list order, one nibble
+// each (0 = unowned, else Game::players index + 1, low nibble first), then
+// LEB128 forces per territory, the turn and the seat order. Lobbies of more
+// than 15 players store owners as varints instead of nibbles.
+class PackedState {
+public:
+    PackedState() = default;
+    PackedState(const Game& game, const TurnState& turn);
+
+    // Overwrites the owner and forces of every territory in `game`, sets
+    // `turn` and the game's side to move, and refreshes the game. Throws
+    // std::runtime_error, leaving both untouched, when the bytes are
+    // malformed or were packed from a different map or lobby size.
+    void apply(Game& game, TurnState& turn) const;
+
+    static PackedState from_bytes(std::vector<std::uint8_t> bytes);
+    const std::vector<std::uint8_t>& bytes() const { return bytes_; }
+    std::size_t size() const { return bytes_.size(); }
+
+    bool operator==(const PackedState& other) const { return bytes_ == other.bytes_; }
+    bool operator!=(const PackedState& other) const { return bytes_ != other.bytes_; }
+
+private:
+    std::vector<std::uint8_t> bytes_;
+};
+
+// Appends the encoding of `game` and `turn` to `out`, so many positions can
+// share one buffer.
+void pack_state(const Game& game, const TurnState& turn, std::vector<std::uint8_t>& out);
+// Decodes one position from `data` into `game` and `turn` as
+// PackedState::apply() does; returns the number of bytes read.
+std::size_t unpack_state(const std::uint8_t* data, std::size_t size, Game& game, TurnState& turn);
+
+}  // namespace pyrisk
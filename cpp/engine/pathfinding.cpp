@@ -0,0 +1,72 @@
+#include "pathfinding.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace pyrisk {
+
+PathFinder::PathFinder(const World& world)
+    : world_(world),
+      cost_(world.territory_list.size()),
+      parent_(world.territory_list.size()),
+      stamp_(world.territory_list.size(), 0) {}
+
+int PathFinder::find(const Territory& src, const Territory& dest, std::vector<Territory*>& path,
+                     const Player* avoid) {
+    path.clear();
+    if (++generation_ == 0) {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        generation_ = 1;
+    }
+    auto reached = [&](std::uint32_t i) { return stamp_[i] == generation_; };
+    const auto& territories = world_.territory_list;
+    const auto target = static_cast<std::uint32_t>(dest.index);
+    const std::greater<std::pair<int, std::uint32_t>> later;
+
+    heap_.clear();
+    auto start = static_cast<std::uint32_t>(src.index);
+    stamp_[start] = generation_;
+    cost_[start] = 0;
+    parent_[start] = start;
+    heap_.emplace_back(0, start);
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        auto [cost, here] = heap_.back();
+        heap_.pop_back();
+        if (cost != cost_[here]) {
+            continue;
+        }
+        if (here == target) {
+            break;
+        }
+        for (auto i = world_.adjacency_offsets[here]; i < world_.adjacency_offsets[here + 1]; ++i) {
+            std::uint32_t next = world_.adjacency[i];
+            const Territory* t = territories[next];
+            if (avoid != nullptr && t->owner == avoid) {
+                continue;
+            }
+            int next_cost = cost + t->forces;
+            if (!reached(next) || next_cost < cost_[next]) {
+                stamp_[next] = generation_;
+                cost_[next] = next_cost;
+                parent_[next] = here;
+                heap_.emplace_back(next_cost, next);
+                std::push_heap(heap_.begin(), heap_.end(), later);
+            }
+        }
+    }
+
+    if (!reached(target)) {
+        return -1;
+    }
+    for (std::uint32_t here = target;; here = parent_[here]) {
+        path.push_back(territories[here]);
+        if (here == start) {
+            break;
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    return cost_[target];
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "game.hpp"
+
+namespace pyrisk {
+
+// Force-weighted shortest paths on the current board: entering a territory
+// costs its forces. Hop distances that ignore the board are answered by
+// World::distance()/route() instead. The scratch buffers are reused, so
+// repeated queries on one finder do not allocate.
+class PathFinder {
+public:
+    explicit PathFinder(const World& world);
+
+    // Writes the cheapest path from `src` to `dest` (both included) to
+    // `path` and returns its cost, or returns -1 and clears `path` when
+    // `dest` is unreachable. With `avoid`, territories owned by that player
+    // are not crossed (except `src`).
+    int find(const Territory& src, const Territory& dest, std::vector<Territory*>& path,
+             const Player* avoid = nullptr);
+
+private:
+    const World& world_;
+    std::vector<int> cost_;
+    std::vector<std::uint32_t> parent_;
+    // cost_/parent_ entries are valid only where stamp_ == generation_.
+    std::vector<std::uint32_t> stamp_;
+    std::uint32_t generation_{0};
+    std::vector<std::pair<int, std::uint32_t>> heap_;
+};
+
+}  // namespace pyrisk
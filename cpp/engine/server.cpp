@@ -0,0 +1,357 @@
+#include "server.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ai_registry.hpp"
+#include "jsonl_sink.hpp"
+#include "world_data.hpp"
+
+namespace pyrisk {
+namespace {
+
+// Splits a file descriptor's input into lines without the newline.
+class LineReader {
+public:
+    explicit LineReader(int fd) : fd_(fd) {}
+
+    bool next(std::string& line) {
+        while (true) {
+            auto newline = buffer_.find('\n', start_);
+            if (newline != std::string::npos) {
+                line.assign(buffer_, start_, newline - start_);
+                start_ = newline + 1;
+                return true;
+            }
+            buffer_.erase(0, start_);
+            start_ = 0;
+            char chunk[1 << 16];
+            ssize_t got = ::read(fd_, chunk, sizeof(chunk));
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                // A last line without a newline still counts.
+                line = std::move(buffer_);
+                buffer_.clear();
+                return !line.empty();
+            }
+            buffer_.append(chunk, static_cast<std::size_t>(got));
+        }
+    }
+
+private:
+    int fd_;
+    std::string buffer_;
+    std::size_t start_{0};
+};
+
+bool write_all(int fd, const std::string& data) {
+    std::size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        written += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+EventMask parse_events(const std::string& value) {
+    if (value == "none") {
+        return kNoEvents;
+    }
+    if (value == "all") {
+        return kAllEvents;
+    }
+    EventMask mask = kNoEvents;
+    for (std::size_t start = 0; start <= value.size();) {
+        std::size_t end = std::min(value.find(',', start), value.size());
+        std::string name = value.substr(start, end - start);
+        start = end + 1;
+        bool known = false;
+        for (std::size_t k = 0; k < static_cast<std::size_t>(EventKind::Count); ++k) {
+            if (event_name(static_cast<EventKind>(k)) == name) {
+                mask |= event_bit(static_cast<EventKind>(k));
+                known = true;
+            }
+        }
+        if (!known) {
+            throw std::invalid_argument("unknown event " + name);
+        }
+    }
+    return mask;
+}
+
+// Digits only, up to `max`: stoull alone would take "-1" as 2^64 - 1.
+std::uint64_t parse_number(const std::string& key, const std::string& value,
+                           std::uint64_t max = std::numeric_limits<std::uint64_t>::max()) {
+    std::size_t used = 0;
+    unsigned long long number = 0;
+    if (!value.empty() && std::isdigit(static_cast<unsigned char>(value[0]))) {
+        try {
+            number = std::stoull(value, &used, 10);
+        } catch (const std::exception&) {
+            used = 0;
+        }
+    }
+    if (used == 0 || used != value.size()) {
+        throw std::invalid_argument("bad number for " + key + ": " + value);
+    }
+    if (number > max) {
+        throw std::invalid_argument(key + " must be at most " + std::to_string(max));
+    }
+    return number;
+}
+
+}  // namespace
+
+GameRequest parse_game_request(const std::string& line, const std::string& default_id) {
+    GameRequest request;
+    request.id = default_id;
+    std::string players;
+    std::size_t pos = 0;
+    while (pos < line.size()) {
+        std::size_t begin = line.find_first_not_of(" \t\r", pos);
+        if (begin == std::string::npos) {
+            break;
+        }
+        std::size_t end = std::min(line.find_first_of(" \t\r", begin), line.size());
+        pos = end;
+        std::string token = line.substr(begin, end - begin);
+        auto equals = token.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument("expected key=value, got " + token);
+        }
+        std::string key = token.substr(0, equals);
+        std::string value = token.substr(equals + 1);
+        if (key == "id") {
+            request.id = value;
+        } else if (key == "players") {
+            players = value;
+        } else if (key == "seed") {
+            request.seed = static_cast<std::uint32_t>(
+                parse_number(key, value, std::numeric_limits<std::uint32_t>::max()));
+        } else if (key == "deal") {
+            request.deal = parse_number(key, value) != 0;
+        } else if (key == "log") {
+            request.events = parse_events(value);
+        } else if (key == "max_turns") {
+            request.limits.max_turns = parse_number(key, value);
+            if (request.limits.max_turns == 0) {
+                throw std::invalid_argument("max_turns must be positive");
+            }
+        } else if (key == "max_events") {
+            request.limits.max_events = parse_number(key, value);
+        } else {
+            throw std::invalid_argument("unknown key " + key);
+        }
+    }
+
+    for (std::size_t start = 0; start < players.size();) {
+        std::size_t end = std::min(players.find(',', start), players.size());
+        std::string entry = players.substr(start, end - start);
+        start = end + 1;
+        auto colon = entry.find(':');
+        std::string name = colon == std::string::npos
+                               ? "P" + std::to_string(request.names.size() + 1)
+                               : entry.substr(0, colon);
+        std::string ai = colon == std::string::npos ? entry : entry.substr(colon + 1);
+        if (!find_ai(ai)) {
+            throw std::invalid_argument("unknown AI " + ai);
+        }
+        if (name.empty() ||
+            std::find(request.names.begin(), request.names.end(), name) != request.names.end()) {
+            throw std::invalid_argument("player names must be unique and non-empty");
+        }
+        request.names.push_back(name);
+        request.ais.push_back(ai);
+    }
+    if (request.names.size() < 2) {
+        throw std::invalid_argument("a game needs at least two players");
+    }
+    return request;
+}
+
+GameServer::GameServer(std::size_t threads) : pool_(threads) {}
+
+std::string GameServer::handle(const std::string& line, const std::string& default_id) {
+    std::string id = default_id;
+    try {
+        GameRequest request = parse_game_request(line, default_id);
+        id = request.id;
+        return play(request);
+    } catch (const std::exception& error) {
+        std::string message = error.what();
+        std::replace(message.begin(), message.end(), '\n', ' ');
+        return "# error " + id + " " + message + "\n";
+    }
+}
+
+std::string GameServer::play(const GameRequest& request) {
+    std::vector<GameDriver::AiFactory> factories;
+    factories.reserve(request.ais.size());
+    for (const auto& ai : request.ais) {
+        factories.push_back(*find_ai(ai));
+    }
+
+    JsonlWriter writer;
+    std::size_t events = 0;
+    EventLogger logger;
+    if (request.events != kNoEvents) {
+        logger = [&](const Event& event) {
+            writer.append(event);
+            ++events;
+        };
+    }
+    GameDriver driver(acquire_world(), request.names, factories, request.deal, std::move(logger),
+                      request.seed);
+    driver.set_logger_events(request.events);
+    driver.set_limits(request.limits);
+    driver.play();
+    release_world(std::move(driver.game().world));
+
+    const auto& result = driver.result();
+    std::string frame = "# game " + request.id + " " +
+                        (result.winner.empty() ? std::string("-") : result.winner) + " " +
+                        (result.adjudicated ? "1" : "0") + " " + std::to_string(result.turns) +
+                        " " + std::to_string(events) + "\n";
+    frame += writer.str();
+    return frame;
+}
+
+World GameServer::acquire_world() {
+    {
+        std::lock_guard<std::mutex> lock(worlds_mutex_);
+        if (!worlds_.empty()) {
+            World world = std::move(worlds_.back());
+            worlds_.pop_back();
+            return world;
+        }
+    }
+    World world;
+    world.load(kAreas, kConnectionData);
+    return world;
+}
+
+void GameServer::release_world(World world) {
+    world.clear_board();
+    std::lock_guard<std::mutex> lock(worlds_mutex_);
+    worlds_.push_back(std::move(world));
+}
+
+bool GameServer::serve(int in_fd, int out_fd) {
+    // The reader queues games on the pool; a writer thread sends frames in
+    // request order as they finish, so a client can wait for each answer.
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::future<std::string>> pending;
+    std::size_t window = pool_.size() * 4;
+    bool done = false;
+    std::atomic<bool> open{true};
+
+    std::thread writer([&]() {
+        while (true) {
+            std::future<std::string> next;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return !pending.empty() || done; });
+                if (pending.empty()) {
+                    return;
+                }
+                next = std::move(pending.front());
+                pending.pop_front();
+            }
+            changed.notify_all();
+            std::string frame = next.get();
+            if (open.load() && !write_all(out_fd, frame)) {
+                open.store(false);
+            }
+        }
+    });
+
+    LineReader reader(in_fd);
+    std::string line;
+    std::size_t sequence = 0;
+    while (open.load() && reader.next(line)) {
+        auto last = line.find_last_not_of(" \t\r");
+        line.erase(last == std::string::npos ? 0 : last + 1);
+        if (line.empty()) {
+            continue;
+        }
+        if (line == "quit") {
+            break;
+        }
+        std::string id = std::to_string(++sequence);
+        auto future = pool_.submit([this, line, id]() { return handle(line, id); });
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return pending.size() < window; });
+        pending.push_back(std::move(future));
+        lock.unlock();
+        changed.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    changed.notify_all();
+    writer.join();
+    return open.load();
+}
+
+void GameServer::listen(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "socket");
+    }
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(fd, 64) < 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "bind " + path);
+    }
+
+    while (true) {
+        int connection = ::accept(fd, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "accept");
+        }
+        std::thread([this, connection]() {
+            serve(connection, connection);
+            ::close(connection);
+        }).detach();
+    }
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "adjudication.hpp"
+#include "game.hpp"
+#include "thread_pool.hpp"
+
+namespace pyrisk {
+
+// One game, parsed from a request line of key=value tokens:
+//
+//   id=7 players=ALPHA:DeterministicAI,BRAVO:StupidAI seed=42 deal=0 log=all
+//
+// `players` is required; an entry without a name is called P<n>. `log` is
+// none (the default), all, or a comma-separated list of event names.
+// `max_turns` and `max_events` set GameLimits. Numbers are plain decimal
+// digits, and `seed` must fit in 32 bits. Games are capped at 1000
+// turns, as in tournaments, unless the request sets another positive cap:
+// an uncapped game could hold a pool thread and every later response on
+// its connection for good.
+struct GameRequest {
+    std::string id;
+    std::vector<std::string> names;
+    std::vector<std::string> ais;
+    std::uint32_t seed{0};
+    bool deal{false};
+    EventMask events{kNoEvents};
+    GameLimits limits{1000, 0};
+};
+
+// Throws std::invalid_argument on malformed lines and unknown AIs.
+GameRequest parse_game_request(const std::string& line, const std::string& default_id);
+
+// A long-running engine that plays requested games on a warm thread pool.
+// Loaded worlds are kept between games and reused, so a game costs neither
+// process start nor World::load().
+//
+// Each request line gets one response frame: a header line followed by the
+// game's event lines as JSON,
+//
+//   # game <id> <winner> <adjudicated> <turns> <events>
+//
+// with "-" for no winner, or "# error <id> <message>" for a bad request.
+// Frames are written in request order. A "quit" line ends the session.
+class GameServer {
+public:
+    explicit GameServer(std::size_t threads = std::thread::hardware_concurrency());
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    // Plays one request line and returns its response frame.
+    std::string handle(const std::string& line, const std::string& default_id);
+
+    // Reads requests from `in_fd` until EOF or "quit", writing frames to
+    // `out_fd`. Returns false if the output side went away.
+    bool serve(int in_fd, int out_fd);
+
+    // Serves every connection to a Unix domain socket at `path` on its own
+    // thread, sharing the pool and worlds. Does not return unless setting
+    // up the socket fails, which throws std::system_error.
+    void listen(const std::string& path);
+
+private:
+    std::string play(const GameRequest& request);
+    World acquire_world();
+    void release_world(World world);
+
+    ThreadPool pool_;
+    std::mutex worlds_mutex_;
+    std::vector<World> worlds_;
+};
+
+}  // namespace pyrisk
@@ -0,0 +1,45 @@
+// Long-running engine: plays games requested one per line on stdin, or on
+// every connection to a Unix domain socket, and answers with framed results
+// and event logs (see server.hpp for the protocol).
+//
+//   pyrisk_server --threads 4 < requests.txt
+//   pyrisk_server --socket /tmp/pyrisk.sock
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "server.hpp"
+
+int main(int argc, char** argv) {
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string socket_path;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--threads") == 0) {
+            threads = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--socket") == 0) {
+            socket_path = argv[i + 1];
+        } else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    // A client that hangs up ends its session instead of the server.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    pyrisk::GameServer server(threads);
+    try {
+        if (!socket_path.empty()) {
+            server.listen(socket_path);
+        }
+        return server.serve(STDIN_FILENO, STDOUT_FILENO) ? 0 : 1;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+}
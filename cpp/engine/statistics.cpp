@@ -0,0 +1,337 @@
+#include "statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+#include "binary_io.hpp"
+
+namespace pyrisk {
+namespace {
+
+constexpr char kMagic[4] = {'P', 'R', 'S', 'T'};
+constexpr std::uint64_t kVersion = 2;
+
+void write_counts(std::ostream& out, const std::vector<std::uint64_t>& counts) {
+    write_varint(out, counts.size());
+    for (auto count : counts) {
+        write_varint(out, count);
+    }
+}
+
+std::vector<std::uint64_t> read_counts(std::istream& in) {
+    // Grown as entries are read, so a corrupt length runs into the end of
+    // the stream instead of a huge allocation.
+    std::vector<std::uint64_t> counts;
+    for (std::uint64_t n = read_varint(in); n > 0; --n) {
+        counts.push_back(read_varint(in));
+    }
+    return counts;
+}
+
+std::vector<std::string> read_names(std::istream& in) {
+    std::vector<std::string> names;
+    for (std::uint64_t n = read_varint(in); n > 0; --n) {
+        names.push_back(read_string(in));
+    }
+    return names;
+}
+
+void add_counts(std::vector<std::uint64_t>& into, const std::vector<std::uint64_t>& from) {
+    if (into.size() != from.size()) {
+        throw std::invalid_argument("cannot merge statistics of different shapes");
+    }
+    for (std::size_t i = 0; i < into.size(); ++i) {
+        into[i] += from[i];
+    }
+}
+
+}  // namespace
+
+Histogram::Histogram(std::size_t bins) : counts_(bins + 1, 0) {}
+
+void Histogram::add(std::size_t value) {
+    ++counts_[std::min(value, counts_.size() - 1)];
+    ++total_;
+}
+
+void Histogram::merge(const Histogram& other) {
+    add_counts(counts_, other.counts_);
+    total_ += other.total_;
+}
+
+void Histogram::save(std::ostream& out) const { write_counts(out, counts_); }
+
+void Histogram::load(std::istream& in) {
+    counts_ = read_counts(in);
+    if (counts_.empty()) {
+        throw std::runtime_error("malformed histogram in statistics file");
+    }
+    total_ = 0;
+    for (auto count : counts_) {
+        total_ += count;
+    }
+}
+
+QuantileSketch::QuantileSketch(double relative_accuracy)
+    : gamma_((1.0 + relative_accuracy) / (1.0 - relative_accuracy)), log_gamma_(std::log(gamma_)) {}
+
+int QuantileSketch::bucket_of(double value) const {
+    return static_cast<int>(std::ceil(std::log(value) / log_gamma_));
+}
+
+void QuantileSketch::add(double value) {
+    ++count_;
+    if (value <= 1e-9) {
+        ++zeros_;
+        return;
+    }
+    int bucket = bucket_of(value);
+    if (buckets_.empty()) {
+        offset_ = bucket;
+    }
+    if (bucket < offset_) {
+        buckets_.insert(buckets_.begin(), static_cast<std::size_t>(offset_ - bucket), 0);
+        offset_ = bucket;
+    }
+    auto slot = static_cast<std::size_t>(bucket - offset_);
+    if (slot >= buckets_.size()) {
+        buckets_.resize(slot + 1, 0);
+    }
+    ++buckets_[slot];
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (std::abs(other.gamma_ - gamma_) > 1e-12) {
+        throw std::invalid_argument("cannot merge sketches with different accuracy");
+    }
+    for (std::size_t i = 0; i < other.buckets_.size(); ++i) {
+        if (other.buckets_[i] == 0) {
+            continue;
+        }
+        int bucket = other.offset_ + static_cast<int>(i);
+        if (buckets_.empty()) {
+            offset_ = bucket;
+        }
+        if (bucket < offset_) {
+            buckets_.insert(buckets_.begin(), static_cast<std::size_t>(offset_ - bucket), 0);
+            offset_ = bucket;
+        }
+        auto slot = static_cast<std::size_t>(bucket - offset_);
+        if (slot >= buckets_.size()) {
+            buckets_.resize(slot + 1, 0);
+        }
+        buckets_[slot] += other.buckets_[i];
+    }
+    zeros_ += other.zeros_;
+    count_ += other.count_;
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(count_ - 1));
+    if (rank < zeros_) {
+        return 0.0;
+    }
+    std::uint64_t seen = zeros_;
+    for (std::size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i];
+        if (seen > rank) {
+            int bucket = offset_ + static_cast<int>(i);
+            return 2.0 * std::pow(gamma_, bucket) / (gamma_ + 1.0);
+        }
+    }
+    return 2.0 * std::pow(gamma_, offset_ + static_cast<int>(buckets_.size()) - 1) / (gamma_ + 1.0);
+}
+
+void QuantileSketch::save(std::ostream& out) const {
+    std::uint64_t gamma_bits = 0;
+    std::memcpy(&gamma_bits, &gamma_, sizeof(gamma_bits));
+    write_varint(out, gamma_bits);
+    // Zig-zag encode the (possibly negative) bucket offset.
+    write_varint(out, (static_cast<std::uint64_t>(offset_) << 1) ^
+                          static_cast<std::uint64_t>(static_cast<std::int64_t>(offset_) >> 63));
+    write_varint(out, zeros_);
+    write_counts(out, buckets_);
+}
+
+void QuantileSketch::load(std::istream& in) {
+    std::uint64_t gamma_bits = read_varint(in);
+    std::memcpy(&gamma_, &gamma_bits, sizeof(gamma_));
+    log_gamma_ = std::log(gamma_);
+    std::uint64_t zigzag = read_varint(in);
+    offset_ = static_cast<int>(static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1));
+    zeros_ = read_varint(in);
+    buckets_ = read_counts(in);
+    count_ = zeros_;
+    for (auto count : buckets_) {
+        count_ += count;
+    }
+}
+
+GameStatistics::GameStatistics(const World& world, std::size_t seats)
+    : seats_(seats),
+      wins_(seats, 0),
+      round_samples_(kRoundBuckets, 0),
+      territory_holding_(kRoundBuckets * world.territory_list.size() * seats, 0),
+      area_holding_(kRoundBuckets * world.area_list.size() * seats, 0) {
+    for (const auto* territory : world.territory_list) {
+        territory_names_.push_back(territory->name);
+    }
+    for (const auto* area : world.area_list) {
+        area_names_.push_back(area->name);
+    }
+}
+
+std::size_t GameStatistics::bucket(std::size_t round) const {
+    return std::min(round, kRoundBuckets - 1);
+}
+
+std::size_t GameStatistics::territory_slot(std::size_t round, std::size_t territory,
+                                           std::size_t seat) const {
+    return (bucket(round) * territory_names_.size() + territory) * seats_ + seat;
+}
+
+std::size_t GameStatistics::area_slot(std::size_t round, std::size_t area, std::size_t seat) const {
+    return (bucket(round) * area_names_.size() + area) * seats_ + seat;
+}
+
+void GameStatistics::sample_round(const Game& game, const std::vector<std::size_t>& seat_of_player,
+                                  std::size_t round) {
+    ++round_samples_[bucket(round)];
+    const Player* players = game.players.data();
+    for (const auto* territory : game.world.territory_list) {
+        if (territory->owner != nullptr) {
+            auto seat = seat_of_player[static_cast<std::size_t>(territory->owner - players)];
+            ++territory_holding_[territory_slot(round, territory->index, seat)];
+        }
+    }
+    for (const auto* area : game.world.area_list) {
+        if (const Player* owner = area->owner()) {
+            auto seat = seat_of_player[static_cast<std::size_t>(owner - players)];
+            ++area_holding_[area_slot(round, area->index, seat)];
+        }
+    }
+}
+
+void GameStatistics::record_game(std::optional<std::size_t> winner_seat, std::size_t turns,
+                                 std::size_t rounds,
+                                 std::optional<std::size_t> first_conquest_round,
+                                 bool adjudicated) {
+    ++games_;
+    if (adjudicated) {
+        ++adjudicated_;
+    }
+    if (winner_seat.has_value()) {
+        ++wins_[winner_seat.value()];
+    } else {
+        ++no_winner_;
+    }
+    length_rounds_.add(rounds);
+    length_turns_.add(static_cast<double>(turns));
+    if (first_conquest_round.has_value()) {
+        first_conquest_.add(first_conquest_round.value());
+    } else {
+        ++no_conquest_;
+    }
+}
+
+void GameStatistics::merge(const GameStatistics& other) {
+    if (other.seats_ != seats_ || other.territory_names_ != territory_names_ ||
+        other.area_names_ != area_names_) {
+        throw std::invalid_argument("cannot merge statistics of different shapes");
+    }
+    games_ += other.games_;
+    no_winner_ += other.no_winner_;
+    adjudicated_ += other.adjudicated_;
+    add_counts(wins_, other.wins_);
+    length_rounds_.merge(other.length_rounds_);
+    length_turns_.merge(other.length_turns_);
+    first_conquest_.merge(other.first_conquest_);
+    no_conquest_ += other.no_conquest_;
+    add_counts(round_samples_, other.round_samples_);
+    add_counts(territory_holding_, other.territory_holding_);
+    add_counts(area_holding_, other.area_holding_);
+}
+
+double GameStatistics::territory_holding(std::size_t round, std::size_t territory,
+                                         std::size_t seat) const {
+    auto samples = round_samples_[bucket(round)];
+    return samples == 0 ? 0.0
+                        : static_cast<double>(territory_holding_[territory_slot(round, territory, seat)]) /
+                              static_cast<double>(samples);
+}
+
+double GameStatistics::area_holding(std::size_t round, std::size_t area, std::size_t seat) const {
+    auto samples = round_samples_[bucket(round)];
+    return samples == 0 ? 0.0
+                        : static_cast<double>(area_holding_[area_slot(round, area, seat)]) /
+                              static_cast<double>(samples);
+}
+
+void GameStatistics::save(std::ostream& out) const {
+    out.write(kMagic, sizeof(kMagic));
+    write_varint(out, kVersion);
+    write_varint(out, seats_);
+    write_varint(out, territory_names_.size());
+    for (const auto& name : territory_names_) {
+        write_string(out, name);
+    }
+    write_varint(out, area_names_.size());
+    for (const auto& name : area_names_) {
+        write_string(out, name);
+    }
+    write_varint(out, games_);
+    write_varint(out, no_winner_);
+    write_varint(out, adjudicated_);
+    write_counts(out, wins_);
+    length_rounds_.save(out);
+    length_turns_.save(out);
+    first_conquest_.save(out);
+    write_varint(out, no_conquest_);
+    write_counts(out, round_samples_);
+    write_counts(out, territory_holding_);
+    write_counts(out, area_holding_);
+}
+
+GameStatistics GameStatistics::load(std::istream& in) {
+    char magic[sizeof(kMagic)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("not a statistics file");
+    }
+    if (read_varint(in) != kVersion) {
+        throw std::runtime_error("unsupported statistics file version");
+    }
+    GameStatistics stats;
+    stats.seats_ = read_varint(in);
+    stats.territory_names_ = read_names(in);
+    stats.area_names_ = read_names(in);
+    stats.games_ = read_varint(in);
+    stats.no_winner_ = read_varint(in);
+    stats.adjudicated_ = read_varint(in);
+    stats.wins_ = read_counts(in);
+    stats.length_rounds_.load(in);
+    stats.length_turns_.load(in);
+    stats.first_conquest_.load(in);
+    stats.no_conquest_ = read_varint(in);
+    stats.round_samples_ = read_counts(in);
+    stats.territory_holding_ = read_counts(in);
+    stats.area_holding_ = read_counts(in);
+
+    // The accessors index these by the header's shape.
+    std::size_t seats = stats.seats_;
+    if (stats.wins_.size() != seats || stats.round_samples_.size() != kRoundBuckets ||
+        stats.territory_holding_.size() != kRoundBuckets * stats.territory_names_.size() * seats ||
+        stats.area_holding_.size() != kRoundBuckets * stats.area_names_.size() * seats) {
+        throw std::runtime_error("statistics file tables do not match its header");
+    }
+    return stats;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+
+namespace pyrisk {
+
+// Counts in unit-width bins [0, bins) plus an overflow bin.
+class Histogram {
+public:
+    explicit Histogram(std::size_t bins = 0);
+
+    void add(std::size_t value);
+    void merge(const Histogram& other);
+
+    std::size_t bins() const { return counts_.size() - 1; }
+    std::uint64_t count(std::size_t bin) const { return counts_[bin]; }
+    std::uint64_t overflow() const { return counts_.back(); }
+    std::uint64_t total() const { return total_; }
+
+    void save(std::ostream& out) const;
+    void load(std::istream& in);
+
+private:
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_{0};
+};
+
+// Log-bucketed quantile sketch (DDSketch) for positive values: quantiles are
+// within `relative_accuracy` of the true value, and sketches with the same
+// accuracy merge exactly.
+class QuantileSketch {
+public:
+    explicit QuantileSketch(double relative_accuracy = 0.01);
+
+    void add(double value);
+    void merge(const QuantileSketch& other);
+    double quantile(double q) const;
+    std::uint64_t count() const { return count_; }
+
+    void save(std::ostream& out) const;
+    void load(std::istream& in);
+
+private:
+    int bucket_of(double value) const;
+
+    double gamma_;
+    double log_gamma_;
+    int offset_{0};
+    std::vector<std::uint64_t> buckets_;
+    std::uint64_t zeros_{0};
+    std::uint64_t count_{0};
+};
+
+// Batch statistics over many games between the same number of seats. Seats
+// are positions in the shuffled turn order, so seat 0 always moves first.
+// One collector is fed by one game at a time; collectors from different
+// threads are combined with merge().
+class GameStatistics {
+public:
+    static constexpr std::size_t kRoundBuckets = 64;
+    static constexpr std::size_t kLengthBins = 512;
+
+    GameStatistics(const World& world, std::size_t seats);
+
+    // Driver hooks. `seat_of_player` maps Game::players indices to seats.
+    void sample_round(const Game& game, const std::vector<std::size_t>& seat_of_player,
+                      std::size_t round);
+    void record_game(std::optional<std::size_t> winner_seat, std::size_t turns, std::size_t rounds,
+                     std::optional<std::size_t> first_conquest_round, bool adjudicated);
+
+    void merge(const GameStatistics& other);
+
+    std::size_t seats() const { return seats_; }
+    const std::vector<std::string>& territory_names() const { return territory_names_; }
+    const std::vector<std::string>& area_names() const { return area_names_; }
+    std::uint64_t games() const { return games_; }
+    std::uint64_t adjudicated() const { return adjudicated_; }
+    std::uint64_t wins(std::size_t seat) const { return wins_[seat]; }
+    const Histogram& length_rounds() const { return length_rounds_; }
+    const QuantileSketch& length_turns() const { return length_turns_; }
+    const Histogram& first_conquest() const { return first_conquest_; }
+    // Fraction of sampled games in which `seat` held the territory or whole
+    // area at the start of `round` (rounds past the last bucket are pooled).
+    double territory_holding(std::size_t round, std::size_t territory, std::size_t seat) const;
+    double area_holding(std::size_t round, std::size_t area, std::size_t seat) const;
+
+    // Compact binary export: a "PRST" header, names, then LEB128 varints.
+    void save(std::ostream& out) const;
+    static GameStatistics load(std::istream& in);
+
+private:
+    GameStatistics() = default;
+    std::size_t bucket(std::size_t round) const;
+    std::size_t territory_slot(std::size_t round, std::size_t territory, std::size_t seat) const;
+    std::size_t area_slot(std::size_t round, std::size_t area, std::size_t seat) const;
+
+    std::size_t seats_{0};
+    std::vector<std::string> territory_names_;
+    std::vector<std::string> area_names_;
+
+    std::uint64_t games_{0};
+    std::uint64_t no_winner_{0};
+    std::uint64_t adjudicated_{0};
+    std::vector<std::uint64_t> wins_;
+    Histogram length_rounds_{kLengthBins};
+    QuantileSketch length_turns_;
+    Histogram first_conquest_{kLengthBins};
+    std::uint64_t no_conquest_{0};
+    std::vector<std::uint64_t> round_samples_;
+    std::vector<std::uint64_t> territory_holding_;
+    std::vector<std::uint64_t> area_holding_;
+};
+
+}  // namespace pyrisk
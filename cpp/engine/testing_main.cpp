@@ -1,21 +1,32 @@
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <random>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include <unistd.h>
+
 #include "ai.hpp"
-#include "event_logging.hpp"
+#include "jsonl_sink.hpp"
+#include "pathfinding.hpp"
+#include "statistics.hpp"
+#include "thread_pool.hpp"
 #include "world_data.hpp"
 
-int main(int argc, char** argv) {
-    using namespace pyrisk;
+namespace {
 
-    std::uint32_t seed = 42;
-    if (argc > 1) {
-        seed = static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10));
-    }
+using namespace pyrisk;
 
+// Plays one DeterministicAI mirror match, reporting every event to `logger`.
+void play_seed(std::uint32_t seed, EventLogger logger) {
     World world;
     world.load(kAreas, kConnectionData);
 
@@ -24,9 +35,152 @@ int main(int argc, char** argv) {
     factories.push_back([](Player& p, Game& g) { return std::make_unique<DeterministicAI>(p, g); });
     factories.push_back([](Player& p, Game& g) { return std::make_unique<DeterministicAI>(p, g); });
 
-    auto logger = [](const Event& event) { std::cout << event_to_json(event) << std::endl; };
-
-    GameDriver driver(std::move(world), names, factories, /*deal=*/false, logger, seed);
+    GameDriver driver(std::move(world), names, factories, /*deal=*/false, std::move(logger), seed);
     driver.play();
+}
+
+void write_all(const std::string& data) { std::fwrite(data.data(), 1, data.size(), stdout); }
+
+// Streaming mode: seeds arrive on stdin, one game per seed, and each game is
+// written as a "# seed <seed> <events>" header followed by its event lines.
+// Frames are emitted in input order regardless of the worker count.
+int stream_seeds(std::size_t workers) {
+    auto play_framed = [](std::uint32_t seed) {
+        JsonlWriter writer;
+        std::size_t count = 0;
+        play_seed(seed, [&](const Event& event) {
+            writer.append(event);
+            ++count;
+        });
+        return "# seed " + std::to_string(seed) + " " + std::to_string(count) + "\n" + writer.str();
+    };
+
+    std::unique_ptr<ThreadPool> pool;
+    if (workers > 1) {
+        pool = std::make_unique<ThreadPool>(workers);
+    }
+    std::deque<std::future<std::string>> pending;
+    std::size_t window = workers * 4;
+
+    unsigned long seed = 0;
+    while (std::cin >> seed) {
+        auto seed32 = static_cast<std::uint32_t>(seed);
+        if (!pool) {
+            write_all(play_framed(seed32));
+            continue;
+        }
+        pending.push_back(pool->submit([=]() { return play_framed(seed32); }));
+        while (pending.size() > window) {
+            write_all(pending.front().get());
+            pending.pop_front();
+        }
+    }
+    while (!pending.empty()) {
+        write_all(pending.front().get());
+        pending.pop_front();
+    }
+    std::fflush(stdout);
+    return 0;
+}
+
+std::string join(const std::vector<Territory*>& path) {
+    std::string out;
+    for (auto* territory : path) {
+        out += (out.empty() ? "" : ",") + territory->name;
+    }
+    return out;
+}
+
+// Path mode: deals the map at random to players A and B, prints it as
+// "T <territory> <owner> <forces>" lines, then one tab-separated line per
+// ordered pair of territories:
+//
+//   P <src> <dst> <hops> <next hop> <route> <cost> <path> <cost avoiding A> <path>
+//
+// for tests/pathfinding_reference.py to check against its own search.
+int print_paths(std::uint32_t seed) {
+    World world;
+    world.load(kAreas, kConnectionData);
+    std::vector<Player> players = {Player("A"), Player("B")};
+    std::mt19937 rng(seed);
+    for (auto* territory : world.territory_list) {
+        territory->owner = &players[rng() % 2];
+        territory->forces = 1 + static_cast<int>(rng() % 20);
+        std::cout << "T\t" << territory->name << "\t" << territory->owner->name << "\t"
+                  << territory->forces << "\n";
+    }
+    PathFinder finder(world);
+    std::vector<Territory*> path;
+    for (auto* src : world.territory_list) {
+        for (auto* dst : world.territory_list) {
+            Territory* hop = world.next_hop(*src, *dst);
+            std::cout << "P\t" << src->name << "\t" << dst->name << "\t"
+                      << world.distance(*src, *dst) << "\t" << (hop ? hop->name : "-") << "\t"
+                      << join(world.route(*src, *dst));
+            int cost = finder.find(*src, *dst, path);
+            std::cout << "\t" << cost << "\t" << join(path);
+            cost = finder.find(*src, *dst, path, &players[0]);
+            std::cout << "\t" << cost << "\t" << join(path) << "\n";
+        }
+    }
+    return 0;
+}
+
+// Statistics mode: loads a --stats file and reads every table through the
+// public accessors, for tests/statistics_file.py. A bad file exits 1 with
+// the error on stderr.
+int check_statistics(const char* path) {
+    try {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error(std::string("cannot open ") + path);
+        }
+        auto stats = GameStatistics::load(in);
+        double held = 0.0;
+        for (std::size_t round = 0; round < GameStatistics::kRoundBuckets; ++round) {
+            for (std::size_t seat = 0; seat < stats.seats(); ++seat) {
+                for (std::size_t t = 0; t < stats.territory_names().size(); ++t) {
+                    held += stats.territory_holding(round, t, seat);
+                }
+                for (std::size_t a = 0; a < stats.area_names().size(); ++a) {
+                    held += stats.area_holding(round, a, seat);
+                }
+            }
+        }
+        std::cout << "games=" << stats.games() << " wins=";
+        for (std::size_t seat = 0; seat < stats.seats(); ++seat) {
+            std::cout << (seat ? "," : "") << stats.wins(seat);
+        }
+        std::cout << " held=" << held << "\n";
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::strcmp(argv[1], "--stats") == 0) {
+        return check_statistics(argv[2]);
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--paths") == 0) {
+        return print_paths(static_cast<std::uint32_t>(std::strtoul(argv[2], nullptr, 10)));
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--stream") == 0) {
+        std::size_t workers = 1;
+        if (argc > 3 && std::strcmp(argv[2], "--workers") == 0) {
+            workers = std::strtoul(argv[3], nullptr, 10);
+        }
+        return stream_seeds(workers);
+    }
+
+    std::uint32_t seed = 42;
+    if (argc > 1) {
+        seed = static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10));
+    }
+    JsonlSink sink(STDOUT_FILENO);
+    play_seed(seed, sink.logger());
     return 0;
 }
@@ -0,0 +1,74 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+namespace pyrisk {
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    threads = std::max<std::size_t>(threads, 1);
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::size() const { return workers_.size(); }
+
+void ThreadPool::enqueue(std::function<void()> task, Priority priority) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (priority == Priority::High) {
+            high_.push_back(std::move(task));
+        } else {
+            normal_.push_back(std::move(task));
+        }
+    }
+    cv_.notify_one();
+}
+
+bool ThreadPool::run_pending_task() {
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (high_.empty()) {
+            return false;
+        }
+        task = std::move(high_.front());
+        high_.pop_front();
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::worker_loop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !high_.empty() || !normal_.empty(); });
+            if (!high_.empty()) {
+                task = std::move(high_.front());
+                high_.pop_front();
+            } else if (!normal_.empty()) {
+                task = std::move(normal_.front());
+                normal_.pop_front();
+            } else {
+                return;
+            }
+        }
+        task();
+    }
+}
+
+}  // namespace pyrisk
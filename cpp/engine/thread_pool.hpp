@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace pyrisk {
+
+class ThreadPool {
+public:
+    enum class Priority { Normal, High };
+
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& task, Priority priority = Priority::Normal)
+        -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+    // Runs one queued high-priority task on the calling thread. Threads that
+    // block on a pool future call this so nested work cannot deadlock the pool.
+    bool run_pending_task();
+
+    template <typename T, typename Clock, typename Duration>
+    std::future_status wait_until(std::future<T>& future,
+                                  const std::chrono::time_point<Clock, Duration>& deadline);
+    template <typename T>
+    void wait(std::future<T>& future);
+
+    std::size_t size() const;
+
+private:
+    void enqueue(std::function<void()> task, Priority priority);
+    void worker_loop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> high_;
+    std::deque<std::function<void()>> normal_;
+    std::vector<std::thread> workers_;
+    bool stopping_{false};
+};
+
+template <typename F>
+auto ThreadPool::submit(F&& task, Priority priority)
+    -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    auto future = packaged->get_future();
+    enqueue([packaged]() { (*packaged)(); }, priority);
+    return future;
+}
+
+template <typename T, typename Clock, typename Duration>
+std::future_status ThreadPool::wait_until(
+    std::future<T>& future, const std::chrono::time_point<Clock, Duration>& deadline) {
+    constexpr auto kSlice = std::chrono::microseconds(200);
+    while (true) {
+        if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            return std::future_status::ready;
+        }
+        if (Clock::now() >= deadline) {
+            return std::future_status::timeout;
+        }
+        if (!run_pending_task()) {
+            future.wait_until(std::min(deadline, Clock::now() + kSlice));
+        }
+    }
+}
+
+template <typename T>
+void ThreadPool::wait(std::future<T>& future) {
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if (!run_pending_task()) {
+            future.wait_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+}  // namespace pyrisk
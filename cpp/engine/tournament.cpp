@@ -0,0 +1,111 @@
+#include "tournament.hpp"
+
+#include <future>
+#include <stdexcept>
+
+#include "world_data.hpp"
+
+namespace pyrisk {
+
+Tournament::Tournament(TournamentConfig config)
+    : config_(std::move(config)), pool_(config_.threads) {
+    if (config_.player_names.size() != config_.factories.size()) {
+        throw std::invalid_argument("player count must match AI factory count");
+    }
+}
+
+ThreadPool& Tournament::pool() { return pool_; }
+
+GameRecord Tournament::play_one(std::uint32_t seed) {
+    TraceSpan span(config_.trace, "game", "game", "seed", seed);
+    auto driver = acquire_driver(seed);
+    std::unique_ptr<GameStatistics> statistics;
+    if (config_.collect_statistics) {
+        statistics = acquire_statistics(driver->game().world);
+    }
+    driver->set_statistics(statistics.get());
+
+    GameRecord record;
+    record.seed = seed;
+    record.winner = driver->play();
+    record.adjudicated = driver->result().adjudicated;
+    record.turns = driver->result().turns;
+    record.decisions = driver->decision_stats();
+    if (statistics) {
+        release_statistics(std::move(statistics));
+    }
+    release_driver(std::move(driver));
+    return record;
+}
+
+std::unique_ptr<GameDriver> Tournament::acquire_driver(std::uint32_t seed) {
+    {
+        std::lock_guard<std::mutex> lock(drivers_mutex_);
+        if (!drivers_.empty()) {
+            auto driver = std::move(drivers_.back());
+            drivers_.pop_back();
+            driver->reset(seed);
+            return driver;
+        }
+    }
+    World world;
+    world.load(kAreas, kConnectionData);
+    auto driver = std::make_unique<GameDriver>(std::move(world), config_.player_names,
+                                               config_.factories, config_.deal, config_.logger,
+                                               seed);
+    driver->set_decision_budget(config_.budget, &pool_);
+    driver->set_limits(config_.limits, config_.scorer);
+    driver->set_trace(config_.trace);
+    return driver;
+}
+
+void Tournament::release_driver(std::unique_ptr<GameDriver> driver) {
+    std::lock_guard<std::mutex> lock(drivers_mutex_);
+    drivers_.push_back(std::move(driver));
+}
+
+std::unique_ptr<GameStatistics> Tournament::acquire_statistics(const World& world) {
+    {
+        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        if (!statistics_.empty()) {
+            auto statistics = std::move(statistics_.back());
+            statistics_.pop_back();
+            return statistics;
+        }
+    }
+    return std::make_unique<GameStatistics>(world, config_.player_names.size());
+}
+
+void Tournament::release_statistics(std::unique_ptr<GameStatistics> statistics) {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    statistics_.push_back(std::move(statistics));
+}
+
+std::optional<GameStatistics> Tournament::statistics() const {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    if (!config_.collect_statistics || statistics_.empty()) {
+        return std::nullopt;
+    }
+    GameStatistics merged = *statistics_.front();
+    for (std::size_t i = 1; i < statistics_.size(); ++i) {
+        merged.merge(*statistics_[i]);
+    }
+    return merged;
+}
+
+std::vector<GameRecord> Tournament::run(const std::vector<std::uint32_t>& seeds) {
+    std::vector<std::future<GameRecord>> pending;
+    pending.reserve(seeds.size());
+    for (auto seed : seeds) {
+        pending.push_back(pool_.submit([this, seed]() { return play_one(seed); }));
+    }
+
+    std::vector<GameRecord> records;
+    records.reserve(seeds.size());
+    for (auto& future : pending) {
+        records.push_back(future.get());
+    }
+    return records;
+}
+
+}  // namespace pyrisk
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ai.hpp"
+#include "decision.hpp"
+#include "statistics.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+
+namespace pyrisk {
+
+struct TournamentConfig {
+    std::vector<std::string> player_names;
+    std::vector<GameDriver::AiFactory> factories;
+    bool deal{false};
+    DecisionBudget budget{};
+    GameLimits limits{};
+    Scorer scorer{score_territories};
+    EventLogger logger{};  // shared by all games, so it must be thread-safe
+    bool collect_statistics{false};
+    TraceRecorder* trace{nullptr};  // spans of every game, each under a "game" span with its seed
+    std::size_t threads{std::thread::hardware_concurrency()};
+};
+
+struct GameRecord {
+    std::uint32_t seed{0};
+    std::string winner;
+    bool adjudicated{false};
+    std::size_t turns{0};
+    std::vector<DecisionStats> decisions;  // indexed like TournamentConfig::player_names
+};
+
+// Plays many independent games on one pool. Games run as normal-priority
+// tasks and their AI decisions as high-priority tasks on the same workers, so
+// thinking from different games interleaves instead of pinning a thread each.
+// Drivers are reset and reused between games rather than rebuilt.
+class Tournament {
+public:
+    explicit Tournament(TournamentConfig config);
+
+    std::vector<GameRecord> run(const std::vector<std::uint32_t>& seeds);
+    ThreadPool& pool();
+
+    // Merged statistics of every game run so far, or nullopt when the
+    // config did not ask for them.
+    std::optional<GameStatistics> statistics() const;
+
+private:
+    GameRecord play_one(std::uint32_t seed);
+    std::unique_ptr<GameStatistics> acquire_statistics(const World& world);
+    void release_statistics(std::unique_ptr<GameStatistics> statistics);
+    std::unique_ptr<GameDriver> acquire_driver(std::uint32_t seed);
+    void release_driver(std::unique_ptr<GameDriver> driver);
+
+    TournamentConfig config_;
+    ThreadPool pool_;
+    // Idle per-game accumulators; at most one per concurrently running game.
+    mutable std::mutex statistics_mutex_;
+    std::vector<std::unique_ptr<GameStatistics>> statistics_;
+    // Idle drivers, likewise.
+    std::mutex drivers_mutex_;
+    std::vector<std::unique_ptr<GameDriver>> drivers_;
+};
+
+}  // namespace pyrisk
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ai_registry.hpp"
+#include "async_logger.hpp"
+#include "coordinator.hpp"
+#include "tournament.hpp"
+#include "world_data.hpp"
+
+namespace {
+
+using namespace pyrisk;
+
+// Plays every seed in its own forked worker process. Only results are
+// collected: decision timings stay in the workers.
+int run_processes(const TournamentConfig& config, std::size_t processes,
+                  const std::vector<std::uint32_t>& seeds) {
+    CoordinatorConfig coordinator_config;
+    coordinator_config.workers = processes;
+    coordinator_config.players = config.player_names.size();
+    ProcessCoordinator coordinator(coordinator_config, [&config](std::uint32_t seed) {
+        World world;
+        world.load(kAreas, kConnectionData);
+        GameDriver driver(std::move(world), config.player_names, config.factories, config.deal,
+                          {}, seed);
+        driver.set_decision_budget(config.budget);
+        driver.set_limits(config.limits, config.scorer);
+        std::string winner = driver.play();
+        auto it = std::find(config.player_names.begin(), config.player_names.end(), winner);
+        SeedOutcome outcome;
+        outcome.winner = it == config.player_names.end()
+                             ? -1
+                             : static_cast<std::int32_t>(it - config.player_names.begin());
+        outcome.adjudicated = driver.result().adjudicated;
+        outcome.turns = static_cast<std::uint32_t>(driver.result().turns);
+        return outcome;
+    });
+    coordinator.run(seeds);
+
+    const auto& summary = coordinator.summary();
+    for (std::size_t i = 0; i < config.player_names.size(); ++i) {
+        std::cout << config.player_names[i] << ": wins=" << summary.wins[i] << std::endl;
+    }
+    std::cout << "adjudicated: " << summary.adjudicated << "/" << summary.games << std::endl;
+    std::cout << "failed seeds: " << summary.failed << " worker crashes: " << summary.crashes
+              << std::endl;
+    return summary.failed == 0 ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t games = 100;
+    long budget_us = 0;
+    std::size_t max_turns = 1000;
+    const char* log_path = nullptr;
+    const char* stats_path = nullptr;
+    const char* trace_path = nullptr;
+    std::string players = "StupidAI,DeterministicAI";
+    std::size_t processes = 0;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 == argc) {
+            std::cerr << "missing value for " << argv[i] << std::endl;
+            return 1;
+        }
+        if (std::strcmp(argv[i], "--games") == 0) {
+            games = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--budget-us") == 0) {
+            budget_us = std::strtol(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--max-turns") == 0) {
+            max_turns = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--log") == 0) {
+            log_path = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            stats_path = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--trace") == 0) {
+            trace_path = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--players") == 0) {
+            players = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--processes") == 0) {
+            processes = std::strtoul(argv[i + 1], nullptr, 10);
+        } else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // Each player is named after its AI class, with a suffix for repeats.
+    TournamentConfig config;
+    for (std::size_t start = 0; start <= players.size();) {
+        std::size_t end = std::min(players.find(',', start), players.size());
+        std::string ai = players.substr(start, end - start);
+        start = end + 1;
+        auto factory = find_ai(ai);
+        if (!factory) {
+            std::cerr << "unknown AI " << ai << std::endl;
+            return 1;
+        }
+        std::string name = ai;
+        for (int copy = 2; std::count(config.player_names.begin(), config.player_names.end(), name); ++copy) {
+            name = ai + std::to_string(copy);
+        }
+        config.player_names.push_back(name);
+        config.factories.push_back(*factory);
+    }
+    config.budget.wall = std::chrono::microseconds(budget_us);
+    config.limits.max_turns = max_turns;
+    config.collect_statistics = stats_path != nullptr;
+
+    std::vector<std::uint32_t> seeds(games);
+    for (std::size_t i = 0; i < games; ++i) {
+        seeds[i] = static_cast<std::uint32_t>(i);
+    }
+
+    if (processes > 0) {
+        if (log_path != nullptr || stats_path != nullptr || trace_path != nullptr) {
+            std::cerr << "--log, --stats and --trace are not supported with --processes"
+                      << std::endl;
+            return 1;
+        }
+        return run_processes(config, processes, seeds);
+    }
+
+    // The AsyncLogger writes to log_fd but does not own it.
+    int log_fd = -1;
+    std::unique_ptr<AsyncLogger> event_log;
+    if (log_path != nullptr) {
+        log_fd = ::open(log_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log_fd < 0) {
+            std::cerr << "cannot open " << log_path << std::endl;
+            return 1;
+        }
+        event_log = std::make_unique<AsyncLogger>(log_fd);
+        config.logger = event_log->logger();
+    }
+
+    std::unique_ptr<TraceRecorder> trace;
+    if (trace_path != nullptr) {
+        trace = std::make_unique<TraceRecorder>();
+        config.trace = trace.get();
+    }
+
+    Tournament tournament(config);
+    auto records = tournament.run(seeds);
+    if (trace) {
+        std::ofstream out(trace_path);
+        trace->write_chrome_trace(out);
+        if (trace->dropped() > 0) {
+            std::cerr << "trace: dropped " << trace->dropped() << " spans" << std::endl;
+        }
+    }
+
+    std::map<std::string, int> wins;
+    int adjudicated = 0;
+    std::vector<DecisionStats> totals(config.player_names.size());
+    for (const auto& record : records) {
+        ++wins[record.winner];
+        adjudicated += record.adjudicated ? 1 : 0;
+        for (std::size_t i = 0; i < totals.size(); ++i) {
+            totals[i].merge(record.decisions[i]);
+        }
+    }
+
+    for (std::size_t i = 0; i < totals.size(); ++i) {
+        const auto& name = config.player_names[i];
+        const auto& latency = totals[i].latency;
+        std::cout << name << ": wins=" << wins[name] << " decisions=" << latency.count()
+                  << " p50<=" << latency.quantile(0.5).count() << "ns"
+                  << " p99<=" << latency.quantile(0.99).count() << "ns"
+                  << " max=" << latency.max().count() << "ns"
+                  << " timeouts=" << totals[i].timeouts
+                  << " over_budget=" << totals[i].over_budget << std::endl;
+    }
+    std::cout << "adjudicated: " << adjudicated << "/" << records.size() << std::endl;
+
+    if (auto statistics = tournament.statistics()) {
+        std::cout << "seat wins:";
+        for (std::size_t seat = 0; seat < config.player_names.size(); ++seat) {
+            std::cout << " " << statistics->wins(seat);
+        }
+        std::cout << " turns p50=" << statistics->length_turns().quantile(0.5)
+                  << " p99=" << statistics->length_turns().quantile(0.99) << std::endl;
+        std::ofstream out(stats_path, std::ios::binary);
+        statistics->save(out);
+    }
+    if (event_log) {
+        try {
+            event_log->flush();
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        event_log.reset();
+        if (::close(log_fd) != 0) {
+            std::cerr << "cannot write " << log_path << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
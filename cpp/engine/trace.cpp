@@ -0,0 +1,111 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace pyrisk {
+namespace {
+
+std::atomic<std::uint64_t> next_recorder_id{1};
+
+// Microseconds with nanosecond decimals, as the trace format expects.
+void append_micros(std::string& out, std::int64_t ns) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%lld.%03lld", static_cast<long long>(ns / 1000),
+                  static_cast<long long>(ns % 1000));
+    out += text;
+}
+
+}  // namespace
+
+TraceRecorder::TraceRecorder(std::size_t max_events_per_thread)
+    : id_(next_recorder_id.fetch_add(1)), max_events_(max_events_per_thread), epoch_(Clock::now()) {}
+
+TraceRecorder::Buffer& TraceRecorder::local_buffer() {
+    // Buffers of recorders that have since been destroyed are only
+    // referenced from here, so they are pruned on the next lookup.
+    thread_local std::vector<std::pair<std::uint64_t, std::shared_ptr<Buffer>>> local;
+    for (auto& [id, buffer] : local) {
+        if (id == id_) {
+            return *buffer;
+        }
+    }
+    local.erase(std::remove_if(local.begin(), local.end(),
+                               [](const auto& entry) { return entry.second.use_count() == 1; }),
+                local.end());
+
+    auto buffer = std::make_shared<Buffer>();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->tid = static_cast<std::uint32_t>(buffers_.size() + 1);
+        buffers_.push_back(buffer);
+    }
+    local.emplace_back(id_, buffer);
+    return *buffer;
+}
+
+void TraceRecorder::record(const char* category, const char* name, Clock::time_point begin,
+                           Clock::time_point end, const char* arg_name, std::int64_t arg) {
+    Buffer& buffer = local_buffer();
+    if (buffer.events.size() >= max_events_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    auto since = [this](Clock::time_point at) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(at - epoch_).count();
+    };
+    buffer.events.push_back({category, name, since(begin), since(end), arg_name, arg});
+}
+
+std::size_t TraceRecorder::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t total = 0;
+    for (const auto& buffer : buffers_) {
+        total += buffer->events.size();
+    }
+    return total;
+}
+
+void TraceRecorder::write_chrome_trace(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string text = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&]() {
+        text += first ? "\n" : ",\n";
+        first = false;
+    };
+    for (const auto& buffer : buffers_) {
+        std::string tid = std::to_string(buffer->tid);
+        separate();
+        text += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid +
+                ",\"args\":{\"name\":\"thread " + tid + "\"}}";
+        for (const auto& event : buffer->events) {
+            separate();
+            text += "{\"name\":\"";
+            text += event.name;
+            text += "\",\"cat\":\"";
+            text += event.category;
+            text += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            append_micros(text, event.begin_ns);
+            text += ",\"dur\":";
+            append_micros(text, event.end_ns - event.begin_ns);
+            if (event.arg_name != nullptr) {
+                text += ",\"args\":{\"";
+                text += event.arg_name;
+                text += "\":" + std::to_string(event.arg) + "}";
+            }
+            text += "}";
+        }
+        if (text.size() > (1 << 20)) {
+            out << text;
+            text.clear();
+        }
+    }
+    text += "\n]}\n";
+    out << text;
+}
+
+}  // namespace pyrisk
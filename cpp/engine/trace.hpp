@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pyrisk {
+
+// One finished span. Names, categories and argument names must be string
+// literals (or otherwise outlive the recorder); nothing is copied.
+struct TraceEvent {
+    const char* category;
+    const char* name;
+    std::int64_t begin_ns;
+    std::int64_t end_ns;
+    const char* arg_name;  // nullptr when the span has no argument
+    std::int64_t arg;
+};
+
+// Collects spans from any number of threads without locking: each thread
+// appends to its own buffer, which becomes one track in the trace viewer.
+// Buffers are capped; spans past the cap are counted and dropped.
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TraceRecorder(std::size_t max_events_per_thread = std::size_t{1} << 20);
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    void record(const char* category, const char* name, Clock::time_point begin,
+                Clock::time_point end, const char* arg_name = nullptr, std::int64_t arg = 0);
+
+    // Writes every span in Chrome trace-event JSON ("X" complete events,
+    // microsecond timestamps from the recorder's creation), loadable in
+    // chrome://tracing or Perfetto. Call once recording threads are done.
+    void write_chrome_trace(std::ostream& out) const;
+
+    std::size_t size() const;
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Buffer {
+        std::uint32_t tid{0};
+        std::vector<TraceEvent> events;
+    };
+
+    Buffer& local_buffer();
+
+    const std::uint64_t id_;
+    const std::size_t max_events_;
+    const Clock::time_point epoch_;
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<Buffer>> buffers_;
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
+// Records the enclosing scope as a span; does nothing without a recorder.
+class TraceSpan {
+public:
+    TraceSpan(TraceRecorder* recorder, const char* category, const char* name,
+              const char* arg_name = nullptr, std::int64_t arg = 0)
+        : recorder_(recorder), category_(category), name_(name), arg_name_(arg_name), arg_(arg) {
+        if (recorder_ != nullptr) {
+            begin_ = TraceRecorder::Clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (recorder_ != nullptr) {
+            recorder_->record(category_, name_, begin_, TraceRecorder::Clock::now(), arg_name_, arg_);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    TraceRecorder* recorder_;
+    const char* category_;
+    const char* name_;
+    const char* arg_name_;
+    std::int64_t arg_;
+    TraceRecorder::Clock::time_point begin_{};
+};
+
+}  // namespace pyrisk
@@ -0,0 +1,125 @@
+// Plays games on several threads that share one TranspositionTable. Every
+// board event checks the incremental Game::hash() against a full rehash,
+// then probes the table with the position and stores it on a miss.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ai_registry.hpp"
+#include "transposition_table.hpp"
+#include "world_data.hpp"
+
+int main(int argc, char** argv) {
+    using namespace pyrisk;
+
+    std::size_t games = 100;
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t table_mb = 16;
+    std::size_t max_turns = 1000;
+    std::string policy_name = "depth";
+    std::string players = "StupidAI,DeterministicAI";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--games") == 0) {
+            games = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            threads = std::max<std::size_t>(1, std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--table-mb") == 0) {
+            table_mb = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--max-turns") == 0) {
+            max_turns = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--policy") == 0) {
+            policy_name = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--players") == 0) {
+            players = argv[i + 1];
+        } else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    ReplacementPolicy policy;
+    if (policy_name == "always") {
+        policy = ReplacementPolicy::Always;
+    } else if (policy_name == "depth") {
+        policy = ReplacementPolicy::DepthPreferred;
+    } else if (policy_name == "aging") {
+        policy = ReplacementPolicy::Aging;
+    } else {
+        std::cerr << "unknown policy " << policy_name << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> names;
+    std::vector<GameDriver::AiFactory> factories;
+    for (std::size_t start = 0; start <= players.size();) {
+        std::size_t end = std::min(players.find(',', start), players.size());
+        std::string ai = players.substr(start, end - start);
+        start = end + 1;
+        auto factory = find_ai(ai);
+        if (!factory) {
+            std::cerr << "unknown AI " << ai << std::endl;
+            return 1;
+        }
+        names.push_back("P" + std::to_string(names.size() + 1));
+        factories.push_back(*factory);
+    }
+
+    TranspositionTable table(table_mb << 20, policy);
+    std::atomic<std::size_t> next_game{0};
+    std::atomic<std::uint64_t> mismatches{0};
+    std::atomic<std::uint64_t> positions{0};
+
+    auto worker = [&]() {
+        std::size_t seed;
+        while ((seed = next_game.fetch_add(1)) < games) {
+            World world;
+            world.load(kAreas, kConnectionData);
+            Game* game = nullptr;
+            auto on_event = [&](const BoardEvent&) {
+                std::uint64_t incremental = game->hash();
+                game->rehash();
+                if (game->hash() != incremental) {
+                    mismatches.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (!table.probe(incremental)) {
+                    auto turns = static_cast<std::uint32_t>(game->event_count());
+                    table.store(incremental, {turns, 0});
+                }
+                positions.fetch_add(1, std::memory_order_relaxed);
+            };
+            GameDriver driver(std::move(world), names, factories, /*deal=*/false, {},
+                              static_cast<std::uint32_t>(seed));
+            game = &driver.game();
+            // Board actions only, and no event strings built for them.
+            driver.set_logger_events(kNoEvents);
+            game->set_observer(on_event);
+            driver.set_limits({max_turns, 0});
+            driver.play();
+            table.new_search();
+        }
+    };
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (std::size_t i = 0; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    auto stats = table.stats();
+    std::cout << "games=" << games << " threads=" << threads << " policy=" << policy_name
+              << " capacity=" << table.capacity() << std::endl;
+    std::cout << "positions=" << positions.load() << " hash_mismatches=" << mismatches.load()
+              << " seconds=" << seconds << std::endl;
+    std::cout << "hits=" << stats.hits << " misses=" << stats.misses << " stores=" << stats.stores
+              << " collisions=" << stats.collisions << " rejected=" << stats.rejected << std::endl;
+    return mismatches.load() == 0 ? 0 : 1;
+}
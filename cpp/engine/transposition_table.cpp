@@ -0,0 +1,147 @@
+#include "transposition_table.hpp"
+
+namespace pyrisk {
+namespace {
+
+// Slot data: bit 63 marks the slot used, then generation, depth and value.
+constexpr std::uint64_t kUsed = std::uint64_t{1} << 63;
+constexpr int kGenerationShift = 48;
+constexpr int kDepthShift = 32;
+
+std::uint64_t pack(TranspositionEntry entry, std::uint8_t generation) {
+    return kUsed | (static_cast<std::uint64_t>(generation) << kGenerationShift) |
+           (static_cast<std::uint64_t>(entry.depth) << kDepthShift) | entry.value;
+}
+
+TranspositionEntry unpack(std::uint64_t data) {
+    return {static_cast<std::uint32_t>(data),
+            static_cast<std::uint16_t>(data >> kDepthShift)};
+}
+
+std::uint8_t generation_of(std::uint64_t data) {
+    return static_cast<std::uint8_t>(data >> kGenerationShift);
+}
+
+std::atomic<std::size_t> next_stripe{0};
+
+}  // namespace
+
+TranspositionTable::TranspositionTable(std::size_t bytes, ReplacementPolicy policy)
+    : policy_(policy), counters_(std::make_unique<Counters[]>(kCounterStripes)) {
+    std::size_t buckets = 1;
+    while (buckets * 2 * sizeof(Bucket) <= bytes) {
+        buckets *= 2;
+    }
+    buckets_ = std::make_unique<Bucket[]>(buckets);
+    mask_ = buckets - 1;
+}
+
+TranspositionTable::Counters& TranspositionTable::counters() const {
+    thread_local std::size_t stripe = next_stripe.fetch_add(1) % kCounterStripes;
+    return counters_[stripe];
+}
+
+std::optional<TranspositionEntry> TranspositionTable::probe(std::uint64_t key) const {
+    const Bucket& bucket = buckets_[key & mask_];
+    for (const Slot& slot : bucket.slots) {
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((data & kUsed) != 0 && (slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+            counters().hits.fetch_add(1, std::memory_order_relaxed);
+            return unpack(data);
+        }
+    }
+    counters().misses.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+}
+
+void TranspositionTable::store(std::uint64_t key, TranspositionEntry entry) {
+    Bucket& bucket = buckets_[key & mask_];
+    std::uint8_t generation = generation_.load(std::memory_order_relaxed);
+    Counters& stats = counters();
+
+    Slot* victim = nullptr;
+    std::uint64_t victim_data = 0;
+    bool victim_stale = false;
+    for (Slot& slot : bucket.slots) {
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((data & kUsed) == 0) {
+            if (victim == nullptr || (victim_data & kUsed) != 0) {
+                victim = &slot;
+                victim_data = data;
+            }
+            continue;
+        }
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+            // Same position: deeper or fresher information wins.
+            if (policy_ != ReplacementPolicy::Always && entry.depth < unpack(data).depth &&
+                generation_of(data) == generation) {
+                stats.rejected.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            victim = &slot;
+            victim_data = 0;
+            break;
+        }
+        if (victim != nullptr && (victim_data & kUsed) == 0) {
+            continue;
+        }
+        bool stale = policy_ == ReplacementPolicy::Aging && generation_of(data) != generation;
+        if (victim == nullptr || (stale && !victim_stale) ||
+            (stale == victim_stale && unpack(data).depth < unpack(victim_data).depth)) {
+            victim = &slot;
+            victim_data = data;
+            victim_stale = stale;
+        }
+    }
+
+    if ((victim_data & kUsed) != 0) {
+        if (policy_ != ReplacementPolicy::Always && !victim_stale &&
+            entry.depth < unpack(victim_data).depth) {
+            stats.rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        stats.collisions.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::uint64_t data = pack(entry, generation);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+    stats.stores.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TranspositionTable::new_search() { generation_.fetch_add(1, std::memory_order_relaxed); }
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i <= mask_; ++i) {
+        for (Slot& slot : buckets_[i].slots) {
+            slot.data.store(0, std::memory_order_relaxed);
+            slot.check.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation_.store(0, std::memory_order_relaxed);
+}
+
+TranspositionStats TranspositionTable::stats() const {
+    TranspositionStats out;
+    for (std::size_t i = 0; i < kCounterStripes; ++i) {
+        const Counters& c = counters_[i];
+        out.hits += c.hits.load(std::memory_order_relaxed);
+        out.misses += c.misses.load(std::memory_order_relaxed);
+        out.stores += c.stores.load(std::memory_order_relaxed);
+        out.collisions += c.collisions.load(std::memory_order_relaxed);
+        out.rejected += c.rejected.load(std::memory_order_relaxed);
+    }
+    return out;
+}
+
+void TranspositionTable::reset_stats() {
+    for (std::size_t i = 0; i < kCounterStripes; ++i) {
+        Counters& c = counters_[i];
+        c.hits.store(0, std::memory_order_relaxed);
+        c.misses.store(0, std::memory_order_relaxed);
+        c.stores.store(0, std::memory_order_relaxed);
+        c.collisions.store(0, std::memory_order_relaxed);
+        c.rejected.store(0, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace pyrisk
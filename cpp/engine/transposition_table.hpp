@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace pyrisk {
+
+// What a search caches per position. `value` is the caller's to interpret
+// (a score, float bits, a move index); `depth` is the search depth or any
+// other measure of how much work the entry is worth.
+struct TranspositionEntry {
+    std::uint32_t value{0};
+    std::uint16_t depth{0};
+};
+
+enum class ReplacementPolicy {
+    Always,          // new entries always go in, evicting the shallowest
+    DepthPreferred,  // a full bucket only gives way to an equal or deeper entry
+    Aging,           // like DepthPreferred, but entries from before the last
+                     // new_search() are evicted first and unconditionally
+};
+
+struct TranspositionStats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t stores{0};
+    std::uint64_t collisions{0};  // stores that evicted a different position
+    std::uint64_t rejected{0};    // stores dropped by the replacement policy
+};
+
+// Fixed-size hash table keyed by Game::hash(), shared lock-free by any
+// number of threads. Each slot keeps its key XORed with its data, so a read
+// torn by a concurrent write fails verification and counts as a miss rather
+// than returning another position's entry. Buckets of four slots fill one
+// cache line.
+class TranspositionTable {
+public:
+    static constexpr std::size_t kBucketSlots = 4;
+
+    // Uses at most `bytes` of memory, rounded down to a power-of-two number
+    // of buckets (at least one).
+    explicit TranspositionTable(std::size_t bytes,
+                                ReplacementPolicy policy = ReplacementPolicy::DepthPreferred);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    std::optional<TranspositionEntry> probe(std::uint64_t key) const;
+    void store(std::uint64_t key, TranspositionEntry entry);
+
+    // Ages every stored entry by one search; only matters for Aging.
+    void new_search();
+    // Empties the table. Not safe while other threads probe or store.
+    void clear();
+
+    std::size_t capacity() const { return (mask_ + 1) * kBucketSlots; }
+    ReplacementPolicy policy() const { return policy_; }
+    TranspositionStats stats() const;
+    void reset_stats();
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+    struct alignas(64) Bucket {
+        Slot slots[kBucketSlots];
+    };
+    // Counters are striped by thread so concurrent searches do not all
+    // write the same cache line.
+    static constexpr std::size_t kCounterStripes = 16;
+    struct alignas(64) Counters {
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+        std::atomic<std::uint64_t> stores{0};
+        std::atomic<std::uint64_t> collisions{0};
+        std::atomic<std::uint64_t> rejected{0};
+    };
+
+    Counters& counters() const;
+
+    std::unique_ptr<Bucket[]> buckets_;
+    std::size_t mask_{0};
+    ReplacementPolicy policy_;
+    std::atomic<std::uint8_t> generation_{0};
+    std::unique_ptr<Counters[]> counters_;
+};
+
+}  // namespace pyrisk
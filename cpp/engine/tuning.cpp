@@ -0,0 +1,180 @@
+#include "tuning.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <ostream>
+#include <stdexcept>
+
+#include "world_data.hpp"
+
+namespace pyrisk {
+
+SpsaTuner::SpsaTuner(std::vector<TuningParameter> parameters, CandidateFactory candidate,
+                     std::vector<GameDriver::AiFactory> opponents, SpsaConfig config,
+                     ThreadPool& pool)
+    : parameters_(std::move(parameters)),
+      candidate_(std::move(candidate)),
+      opponents_(std::move(opponents)),
+      config_(config),
+      pool_(pool) {
+    if (parameters_.empty() || opponents_.empty()) {
+        throw std::invalid_argument("tuning needs parameters and at least one opponent");
+    }
+}
+
+bool SpsaTuner::candidate_wins(const GameDriver::AiFactory& candidate, std::uint32_t seed) const {
+    std::size_t players = opponents_.size() + 1;
+    std::size_t seat = seed % players;
+    std::vector<std::string> names;
+    std::vector<GameDriver::AiFactory> factories;
+    for (std::size_t i = 0, opponent = 0; i < players; ++i) {
+        names.push_back("P" + std::to_string(i + 1));
+        factories.push_back(i == seat ? candidate : opponents_[opponent++]);
+    }
+    World world;
+    world.load(kAreas, kConnectionData);
+    GameDriver driver(std::move(world), names, factories, /*deal=*/false, {}, seed);
+    driver.set_logger_events(kNoEvents);
+    driver.set_limits(config_.limits);
+    return driver.play() == names[seat];
+}
+
+std::vector<double> SpsaTuner::evaluate(const std::vector<std::vector<double>>& candidates,
+                                        std::uint32_t first_seed, std::size_t games) {
+    std::vector<GameDriver::AiFactory> factories;
+    for (const auto& theta : candidates) {
+        factories.push_back(candidate_(theta));
+    }
+    std::vector<std::future<bool>> pending;
+    pending.reserve(candidates.size() * games);
+    for (const auto& factory : factories) {
+        for (std::size_t g = 0; g < games; ++g) {
+            auto seed = first_seed + static_cast<std::uint32_t>(g);
+            pending.push_back(
+                pool_.submit([this, &factory, seed]() { return candidate_wins(factory, seed); }));
+        }
+    }
+    std::vector<double> rates(candidates.size(), 0.0);
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        if (pending[i].get()) {
+            rates[i / games] += 1.0;
+        }
+    }
+    for (auto& rate : rates) {
+        rate /= static_cast<double>(std::max<std::size_t>(1, games));
+    }
+    return rates;
+}
+
+std::vector<double> SpsaTuner::run(std::ostream* log) {
+    // Work in [0, 1] per parameter so one step size fits them all.
+    std::size_t n = parameters_.size();
+    std::vector<double> u(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto& p = parameters_[i];
+        u[i] = std::clamp((p.initial - p.low) / (p.high - p.low), 0.0, 1.0);
+    }
+    auto to_theta = [&](const std::vector<double>& point) {
+        std::vector<double> theta(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            theta[i] = parameters_[i].low + point[i] * (parameters_[i].high - parameters_[i].low);
+        }
+        return theta;
+    };
+
+    PythonicRNG rng(config_.seed);
+    std::size_t pairs = std::max<std::size_t>(1, config_.pairs);
+    for (std::size_t k = 0; k < config_.iterations; ++k) {
+        double a_k = config_.a / std::pow(static_cast<double>(k + 1) + config_.stability, config_.alpha);
+        double c_k = config_.c / std::pow(static_cast<double>(k + 1), config_.gamma);
+
+        std::vector<std::vector<double>> deltas(pairs, std::vector<double>(n));
+        std::vector<std::vector<double>> population;
+        for (auto& delta : deltas) {
+            std::vector<double> plus(n);
+            std::vector<double> minus(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                delta[i] = rng.randbelow(2) == 0 ? -1.0 : 1.0;
+                plus[i] = std::clamp(u[i] + c_k * delta[i], 0.0, 1.0);
+                minus[i] = std::clamp(u[i] - c_k * delta[i], 0.0, 1.0);
+            }
+            population.push_back(to_theta(plus));
+            population.push_back(to_theta(minus));
+        }
+        auto first_seed = config_.seed + static_cast<std::uint32_t>(k * config_.games);
+        auto rates = evaluate(population, first_seed, config_.games);
+
+        std::vector<double> gradient(n, 0.0);
+        double plus_mean = 0.0;
+        double minus_mean = 0.0;
+        for (std::size_t j = 0; j < pairs; ++j) {
+            double difference = rates[2 * j] - rates[2 * j + 1];
+            for (std::size_t i = 0; i < n; ++i) {
+                gradient[i] += difference / (2.0 * c_k * deltas[j][i]) / static_cast<double>(pairs);
+            }
+            plus_mean += rates[2 * j] / static_cast<double>(pairs);
+            minus_mean += rates[2 * j + 1] / static_cast<double>(pairs);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            u[i] = std::clamp(u[i] + a_k * gradient[i], 0.0, 1.0);
+        }
+
+        if (log != nullptr) {
+            auto theta = to_theta(u);
+            *log << "{\"iteration\":" << k + 1 << ",\"plus\":" << plus_mean
+                 << ",\"minus\":" << minus_mean << ",\"a\":" << a_k << ",\"c\":" << c_k
+                 << ",\"theta\":{";
+            for (std::size_t i = 0; i < n; ++i) {
+                *log << (i > 0 ? "," : "") << "\"" << parameters_[i].name << "\":" << theta[i];
+            }
+            *log << "}}\n" << std::flush;
+        }
+    }
+    return to_theta(u);
+}
+
+std::vector<TuningParameter> deterministic_parameters() {
+    DeterministicParams defaults;
+    return {{"attack_ratio", defaults.attack_ratio, 0.5, 2.0},
+            {"attack_margin", defaults.attack_margin, -1.0, 5.0},
+            {"continue_margin", defaults.continue_margin, -1.0, 3.0},
+            {"move_cap", static_cast<double>(defaults.move_cap), 1.0, 20.0},
+            {"reinforce_spread", static_cast<double>(defaults.reinforce_spread), 0.0, 8.0}};
+}
+
+DeterministicParams deterministic_params(const std::vector<double>& theta) {
+    DeterministicParams params;
+    params.attack_ratio = theta.at(0);
+    params.attack_margin = theta.at(1);
+    params.continue_margin = theta.at(2);
+    params.move_cap = static_cast<int>(std::lround(theta.at(3)));
+    params.reinforce_spread = static_cast<std::size_t>(std::max(0L, std::lround(theta.at(4))));
+    return params;
+}
+
+DeterministicParams parse_deterministic_params(const std::string& list) {
+    auto parameters = deterministic_parameters();
+    std::vector<double> theta;
+    for (const auto& parameter : parameters) {
+        theta.push_back(parameter.initial);
+    }
+    for (std::size_t start = 0; start < list.size();) {
+        std::size_t end = std::min(list.find(',', start), list.size());
+        std::string entry = list.substr(start, end - start);
+        start = end + 1;
+        auto equals = entry.find('=');
+        auto it = std::find_if(parameters.begin(), parameters.end(), [&](const TuningParameter& p) {
+            return equals != std::string::npos && p.name == entry.substr(0, equals);
+        });
+        if (it == parameters.end()) {
+            throw std::invalid_argument("unknown parameter " + entry);
+        }
+        theta[static_cast<std::size_t>(it - parameters.begin())] =
+            std::strtod(entry.c_str() + equals + 1, nullptr);
+    }
+    return deterministic_params(theta);
+}
+
+}  // namespace pyrisk
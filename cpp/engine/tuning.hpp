@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "ai.hpp"
+#include "thread_pool.hpp"
+
+namespace pyrisk {
+
+struct TuningParameter {
+    std::string name;
+    double initial{0.0};
+    double low{0.0};
+    double high{1.0};
+};
+
+// Simultaneous perturbation stochastic approximation. Step and perturbation
+// sizes are fractions of each parameter's [low, high] range; at iteration k
+// they are a / (k + 1 + stability)^alpha and c / (k + 1)^gamma.
+struct SpsaConfig {
+    std::size_t iterations{50};
+    std::size_t games{200};  // per candidate; every candidate of an iteration plays the same seeds
+    std::size_t pairs{1};    // perturbation pairs averaged per iteration
+    double a{0.2};
+    double c{0.1};
+    double stability{5.0};
+    double alpha{0.602};
+    double gamma{0.101};
+    std::uint32_t seed{1};
+    GameLimits limits{1000, 0};
+};
+
+// Builds the AI under tuning from a parameter vector, in TuningParameter order.
+using CandidateFactory = std::function<GameDriver::AiFactory(const std::vector<double>& theta)>;
+
+// Tunes one AI's parameters for win rate against a fixed lineup of
+// opponents. Each iteration plays all of its candidates' games at once on
+// `pool`, on a fresh block of seeds shared by every candidate (common random
+// numbers), with the candidate rotating through the seats.
+class SpsaTuner {
+public:
+    SpsaTuner(std::vector<TuningParameter> parameters, CandidateFactory candidate,
+              std::vector<GameDriver::AiFactory> opponents, SpsaConfig config, ThreadPool& pool);
+
+    // Returns the tuned parameters. With `log`, writes one JSON line per
+    // iteration: the parameters, both perturbed win rates and the step sizes.
+    std::vector<double> run(std::ostream* log = nullptr);
+
+    // Win rate of each candidate over `games` games from `first_seed` on.
+    std::vector<double> evaluate(const std::vector<std::vector<double>>& candidates,
+                                 std::uint32_t first_seed, std::size_t games);
+
+private:
+    bool candidate_wins(const GameDriver::AiFactory& candidate, std::uint32_t seed) const;
+
+    std::vector<TuningParameter> parameters_;
+    CandidateFactory candidate_;
+    std::vector<GameDriver::AiFactory> opponents_;
+    SpsaConfig config_;
+    ThreadPool& pool_;
+};
+
+// DeterministicParams as tunable parameters, and back.
+std::vector<TuningParameter> deterministic_parameters();
+DeterministicParams deterministic_params(const std::vector<double>& theta);
+// Parses "name=value,..." over the defaults, for command lines. Throws
+// std::invalid_argument on unknown names.
+DeterministicParams parse_deterministic_params(const std::string& list);
+
+}  // namespace pyrisk
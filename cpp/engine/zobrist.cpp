@@ -0,0 +1,44 @@
+#include "zobrist.hpp"
+
+namespace pyrisk {
+namespace zobrist {
+namespace {
+
+constexpr std::uint64_t kTerritorySalt = 0x9E3779B97F4A7C15ull;
+constexpr std::uint64_t kSideSalt = 0xD1B54A32D192ED03ull;
+
+// splitmix64 finaliser.
+std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+}  // namespace
+
+int forces_bucket(int forces) {
+    if (forces < kExactForces) {
+        return forces < 0 ? 0 : forces;
+    }
+    int bucket = kExactForces;
+    for (int f = forces >> 5; f != 0; f >>= 1) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+std::uint64_t territory_key(std::size_t territory, std::size_t owner_slot, int forces) {
+    auto bucket = static_cast<std::uint64_t>(forces_bucket(forces));
+    return mix(kTerritorySalt ^ (static_cast<std::uint64_t>(territory) << 32) ^
+               (static_cast<std::uint64_t>(owner_slot) << 8) ^ bucket);
+}
+
+std::uint64_t side_key(std::size_t player) {
+    return mix(kSideSalt ^ static_cast<std::uint64_t>(player));
+}
+
+}  // namespace zobrist
+}  // namespace pyrisk
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyrisk {
+
+// Zobrist keys for position hashing. Keys are derived from their indices by
+// a fixed mixing function rather than stored in tables, so they cost no
+// memory per game, work for any map or lobby size, and agree across
+// processes.
+namespace zobrist {
+
+// Forces are hashed by bucket: exact below 16, then one bucket per power of
+// two, so armies that differ by a few units deep in a stack hash alike.
+constexpr int kExactForces = 16;
+int forces_bucket(int forces);
+
+// `owner_slot` is 0 for an unowned territory, else the Game::players index + 1.
+std::uint64_t territory_key(std::size_t territory, std::size_t owner_slot, int forces);
+std::uint64_t side_key(std::size_t player);
+
+}  // namespace zobrist
+}  // namespace pyrisk
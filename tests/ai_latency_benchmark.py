@@ -0,0 +1,154 @@
+"""Compare per-decision latency of the Python AIs with their C++ ports.
+
+A decision is one call to initial_placement, reinforce or freemove, or one
+step of the attack generator, matching what the C++ driver times. Python
+games are cut off after --max-turns turns, like the C++ tournament.
+"""
+import argparse
+import logging
+import random
+import re
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+sys.path.append(str(ROOT))
+
+from ai.al import AlAI
+from ai.better import BetterAI
+from ai.chron import ChronAI
+from game import Game
+from world import AREAS, CONNECT, KEY, MAP
+
+BUILD_DIR = ROOT / "build"
+CPP_BINARY = BUILD_DIR / "pyrisk_tournament"
+AIS = {"ChronAI": ChronAI, "AlAI": AlAI, "BetterAI": BetterAI}
+
+
+class TurnLimit(Exception):
+    pass
+
+
+def timed_class(base, samples, turns, limit):
+    """Subclass `base` so every decision appends its duration (ns) to `samples`.
+
+    `turns` is a one-element list shared by the players of one game.
+    """
+
+    class Timed(base):
+        def _time(self, method, *args):
+            start = time.perf_counter_ns()
+            result = method(self, *args)
+            samples.append(time.perf_counter_ns() - start)
+            return result
+
+        def initial_placement(self, empty, remaining):
+            return self._time(base.initial_placement, empty, remaining)
+
+        def reinforce(self, available):
+            turns[0] += 1
+            if turns[0] > limit:
+                raise TurnLimit()
+            return self._time(base.reinforce, available)
+
+        def attack(self):
+            steps = base.attack(self)
+            while True:
+                start = time.perf_counter_ns()
+                try:
+                    step = next(steps)
+                except StopIteration:
+                    samples.append(time.perf_counter_ns() - start)
+                    return
+                samples.append(time.perf_counter_ns() - start)
+                yield step
+
+        def freemove(self):
+            return self._time(base.freemove)
+
+    Timed.__name__ = base.__name__
+    return Timed
+
+
+def run_python(players, games, max_turns):
+    samples = {name: [] for name in players}
+    for seed in range(games):
+        random.seed(seed)
+        game = Game(curses=False, color=False, delay=0, connect=CONNECT, areas=AREAS,
+                    cmap=MAP, ckey=KEY, wait=False, deal=False)
+        turns = [0]
+        for name in players:
+            game.add_player(name, timed_class(AIS[name], samples[name], turns, max_turns))
+        try:
+            game.play()
+        except TurnLimit:
+            pass
+    return samples
+
+
+def is_stale(binary):
+    """True when `binary` is missing or older than any engine source."""
+    if not binary.exists():
+        return True
+    built = binary.stat().st_mtime
+    engine = ROOT / "cpp" / "engine"
+    return any(s.stat().st_mtime > built for s in engine.iterdir() if s.suffix in (".cpp", ".hpp"))
+
+
+def build_cpp_tournament():
+    BUILD_DIR.mkdir(exist_ok=True)
+    engine = ROOT / "cpp" / "engine"
+    sources = [s for s in sorted(engine.glob("*.cpp")) if not s.name.endswith("_main.cpp")]
+    sources.append(engine / "tournament_main.cpp")
+    cmd = ["g++", "-std=c++17", "-O2", "-pthread", "-o", str(CPP_BINARY)] + [str(s) for s in sources]
+    subprocess.check_call(cmd)
+
+
+def run_cpp(players, games, max_turns):
+    if is_stale(CPP_BINARY):
+        build_cpp_tournament()
+    result = subprocess.run(
+        [str(CPP_BINARY), "--games", str(games), "--max-turns", str(max_turns),
+         "--players", ",".join(players)],
+        check=True, capture_output=True, text=True)
+    stats = {}
+    pattern = re.compile(r"^(\w+): wins=\d+ decisions=(\d+) p50<=(\d+)ns p99<=(\d+)ns max=(\d+)ns")
+    for line in result.stdout.splitlines():
+        match = pattern.match(line)
+        if match:
+            stats[match.group(1)] = tuple(int(v) for v in match.group(2, 3, 4, 5))
+    return stats
+
+
+def quantile(values, q):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(q * len(ordered)))] if ordered else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--games", type=int, default=5)
+    parser.add_argument("--max-turns", type=int, default=300)
+    parser.add_argument("players", nargs="*", default=["ChronAI", "AlAI", "BetterAI"])
+    args = parser.parse_args()
+    logging.disable(logging.WARNING)
+
+    python = run_python(args.players, args.games, args.max_turns)
+    cpp = run_cpp(args.players, args.games, args.max_turns)
+
+    print("%-10s %-6s %10s %12s %12s %14s" % ("AI", "engine", "decisions", "p50 (us)", "p99 (us)", "max (us)"))
+    for name in args.players:
+        samples = python[name]
+        print("%-10s %-6s %10d %12.1f %12.1f %14.1f" % (
+            name, "python", len(samples), quantile(samples, 0.5) / 1e3,
+            quantile(samples, 0.99) / 1e3, max(samples, default=0) / 1e3))
+        count, p50, p99, worst = cpp.get(name, (0, 0, 0, 0))
+        # The C++ histogram reports power-of-two upper bounds.
+        print("%-10s %-6s %10d %12.1f %12.1f %14.1f" % (
+            name, "c++", count, p50 / 1e3, p99 / 1e3, worst / 1e3))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,80 @@
+"""Replay C++ engine runs that once failed to finish.
+
+Each case runs an engine binary under a wall-clock timeout and fails if it
+hangs, crashes or exits non-zero.
+"""
+import argparse
+import subprocess
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+BUILD_DIR = ROOT / "build"
+BINARIES = {
+    "pyrisk_tournament": "tournament_main.cpp",
+    "pyrisk_ladder": "ladder_main.cpp",
+}
+
+# (description, binary, arguments, timeout in seconds)
+CASES = [
+    # ChronAI sized attacks with exact battle odds on stacks in the hundreds,
+    # so this stalemate slowed to a halt inside one reinforce() decision.
+    ("StupidAI vs ChronAI stalemate", "pyrisk_tournament",
+     ["--games", "1", "--players", "StupidAI,ChronAI"], 60),
+    ("StupidAI vs ChronAI under a decision budget", "pyrisk_tournament",
+     ["--games", "1", "--players", "StupidAI,ChronAI", "--budget-us", "100000"], 60),
+    # One stuck pair used to hold up the whole ladder and its checkpoints.
+    ("four-AI ladder", "pyrisk_ladder",
+     ["--ais", "DeterministicAI,StupidAI,AlAI,ChronAI", "--threads", "1"], 120),
+]
+
+
+def is_stale(binary):
+    """True when `binary` is missing or older than any engine source."""
+    if not binary.exists():
+        return True
+    built = binary.stat().st_mtime
+    engine = ROOT / "cpp" / "engine"
+    return any(s.stat().st_mtime > built for s in engine.iterdir() if s.suffix in (".cpp", ".hpp"))
+
+
+def build(binary):
+    BUILD_DIR.mkdir(exist_ok=True)
+    engine = ROOT / "cpp" / "engine"
+    sources = [s for s in sorted(engine.glob("*.cpp")) if not s.name.endswith("_main.cpp")]
+    sources.append(engine / BINARIES[binary])
+    cmd = ["g++", "-std=c++17", "-O2", "-pthread", "-o", str(BUILD_DIR / binary)]
+    subprocess.check_call(cmd + [str(s) for s in sources])
+
+
+def run_case(description, binary, arguments, timeout):
+    path = BUILD_DIR / binary
+    if is_stale(path):
+        build(binary)
+    try:
+        result = subprocess.run([str(path)] + arguments, capture_output=True, text=True,
+                                timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return f"did not finish within {timeout}s"
+    if result.returncode != 0:
+        return f"exited with {result.returncode}: {result.stderr.strip()}"
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--timeout-scale", type=float, default=1.0,
+                        help="multiply every case's timeout, for slow machines")
+    args = parser.parse_args()
+
+    failures = 0
+    for description, binary, arguments, timeout in CASES:
+        error = run_case(description, binary, arguments, timeout * args.timeout_scale)
+        print(f"{description}: {error or 'ok'}")
+        failures += error is not None
+    if failures:
+        raise AssertionError(f"{failures} of {len(CASES)} regression runs failed")
+    print(f"All {len(CASES)} regression runs finished")
+
+
+if __name__ == "__main__":
+    main()
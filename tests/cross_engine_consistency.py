@@ -1,6 +1,8 @@
+import argparse
 import json
 import random
 import subprocess
+from multiprocessing import Pool
 from pathlib import Path
 import sys
 
@@ -12,16 +14,24 @@ from game import Game
 from world import AREAS, CONNECT, KEY, MAP
 BUILD_DIR = ROOT / "build"
 CPP_BINARY = BUILD_DIR / "pyrisk_engine_tester"
+SERVER_BINARY = BUILD_DIR / "pyrisk_server"
 
 
-def build_cpp_tester():
+def is_stale(binary):
+    """True when `binary` is missing or older than any engine source."""
+    if not binary.exists():
+        return True
+    built = binary.stat().st_mtime
+    engine = ROOT / "cpp" / "engine"
+    return any(s.stat().st_mtime > built for s in engine.iterdir() if s.suffix in (".cpp", ".hpp"))
+
+
+def build_cpp_tester(main="testing_main.cpp", binary=CPP_BINARY):
     BUILD_DIR.mkdir(exist_ok=True)
-    sources = [
-        ROOT / "cpp" / "engine" / "ai.cpp",
-        ROOT / "cpp" / "engine" / "game.cpp",
-        ROOT / "cpp" / "engine" / "testing_main.cpp",
-    ]
-    cmd = ["g++", "-std=c++17", "-O2", "-o", str(CPP_BINARY)] + [str(s) for s in sources]
+    engine = ROOT / "cpp" / "engine"
+    sources = [s for s in sorted(engine.glob("*.cpp")) if not s.name.endswith("_main.cpp")]
+    sources.append(engine / main)
+    cmd = ["g++", "-std=c++17", "-O2", "-pthread", "-o", str(binary)] + [str(s) for s in sources]
     subprocess.check_call(cmd)
 
 
@@ -47,7 +57,7 @@ def run_python_engine(seed: int):
 
 
 def run_cpp_engine(seed: int):
-    if not CPP_BINARY.exists():
+    if is_stale(CPP_BINARY):
         build_cpp_tester()
     result = subprocess.run(
         [str(CPP_BINARY), str(seed)], check=True, capture_output=True, text=True
@@ -55,6 +65,66 @@ def run_cpp_engine(seed: int):
     return [json.loads(line) for line in result.stdout.splitlines() if line.strip()]
 
 
+def run_cpp_engine_stream(seeds, workers=1):
+    """Run many seeds through one tester process and split its framed output per seed."""
+    if is_stale(CPP_BINARY):
+        build_cpp_tester()
+    result = subprocess.run(
+        [str(CPP_BINARY), "--stream", "--workers", str(workers)],
+        input="\n".join(str(s) for s in seeds) + "\n",
+        check=True,
+        capture_output=True,
+        text=True,
+    )
+    logs = {}
+    lines = result.stdout.splitlines()
+    idx = 0
+    while idx < len(lines):
+        _, tag, seed, count = lines[idx].split()
+        assert tag == "seed", lines[idx]
+        count = int(count)
+        logs[int(seed)] = [json.loads(line) for line in lines[idx + 1 : idx + 1 + count]]
+        idx += 1 + count
+    return logs
+
+
+def run_cpp_engine_server(seeds, workers=1):
+    """Run many seeds as requests to one long-running server process."""
+    if is_stale(SERVER_BINARY):
+        build_cpp_tester("server_main.cpp", SERVER_BINARY)
+    requests = "".join(
+        f"id={seed} players=ALPHA:DeterministicAI,BRAVO:DeterministicAI seed={seed} log=all\n"
+        for seed in seeds
+    )
+    result = subprocess.run(
+        [str(SERVER_BINARY), "--threads", str(workers)],
+        input=requests,
+        check=True,
+        capture_output=True,
+        text=True,
+    )
+    logs = {}
+    lines = result.stdout.splitlines()
+    idx = 0
+    while idx < len(lines):
+        fields = lines[idx].split()
+        assert fields[1] == "game", lines[idx]
+        count = int(fields[-1])
+        logs[int(fields[2])] = [json.loads(line) for line in lines[idx + 1 : idx + 1 + count]]
+        idx += 1 + count
+    return logs
+
+
+def first_divergence(python_log, cpp_log):
+    """Return a description of the first differing event, or None if the logs match."""
+    for idx, (py_event, cpp_event) in enumerate(zip(python_log, cpp_log)):
+        if py_event != cpp_event:
+            return f"event {idx}: python={py_event} cpp={cpp_event}"
+    if len(python_log) != len(cpp_log):
+        return f"event count mismatch: python={len(python_log)} cpp={len(cpp_log)}"
+    return None
+
+
 def compare_logs(python_log, cpp_log):
     if len(python_log) != len(cpp_log):
         raise AssertionError(f"Event count mismatch: python={len(python_log)} cpp={len(cpp_log)}")
@@ -66,7 +136,38 @@ def compare_logs(python_log, cpp_log):
             )
 
 
+def check_many(start, count, workers, batch, server=False):
+    failures = {}
+    run_cpp = run_cpp_engine_server if server else run_cpp_engine_stream
+    with Pool(workers) as pool:
+        for offset in range(0, count, batch):
+            seeds = list(range(start + offset, start + min(offset + batch, count)))
+            cpp_logs = run_cpp(seeds, workers)
+            python_logs = pool.map(run_python_engine, seeds, chunksize=max(1, len(seeds) // (4 * workers)))
+            for seed, python_log in zip(seeds, python_logs):
+                divergence = first_divergence(python_log, cpp_logs.get(seed, []))
+                if divergence:
+                    failures[seed] = divergence
+                    print(f"seed {seed}: {divergence}")
+    return failures
+
+
 def main():
+    parser = argparse.ArgumentParser(description="Compare Python and C++ engine event logs.")
+    parser.add_argument("--seeds", type=int, default=0, help="check this many consecutive seeds")
+    parser.add_argument("--start", type=int, default=0, help="first seed for --seeds")
+    parser.add_argument("--workers", type=int, default=1, help="parallel workers on each side")
+    parser.add_argument("--batch", type=int, default=1000, help="seeds per tester process")
+    parser.add_argument("--server", action="store_true", help="play --seeds through pyrisk_server")
+    args = parser.parse_args()
+
+    if args.seeds:
+        failures = check_many(args.start, args.seeds, args.workers, args.batch, args.server)
+        if failures:
+            raise AssertionError(f"{len(failures)} of {args.seeds} seeds diverged")
+        print(f"Engine logs match for {args.seeds} seeds starting at {args.start}")
+        return
+
     seed = 42
     python_log = run_python_engine(seed)
     cpp_log = run_cpp_engine(seed)
@@ -0,0 +1,143 @@
+"""Check the C++ hop tables and PathFinder against a reference search.
+
+The engine tester deals the map at random and prints, for every ordered pair
+of territories, World::distance/next_hop/route and PathFinder::find with and
+without an avoided player. This script rebuilds the map from world.py and
+checks each answer against a plain breadth-first search and Dijkstra.
+"""
+import argparse
+import heapq
+import subprocess
+from collections import deque
+from pathlib import Path
+import sys
+
+ROOT = Path(__file__).resolve().parent.parent
+sys.path.append(str(ROOT))
+
+from territory import World
+from world import AREAS, CONNECT
+BUILD_DIR = ROOT / "build"
+CPP_BINARY = BUILD_DIR / "pyrisk_engine_tester"
+
+
+def is_stale(binary):
+    """True when `binary` is missing or older than any engine source."""
+    if not binary.exists():
+        return True
+    built = binary.stat().st_mtime
+    engine = ROOT / "cpp" / "engine"
+    return any(s.stat().st_mtime > built for s in engine.iterdir() if s.suffix in (".cpp", ".hpp"))
+
+
+def build_cpp_tester():
+    BUILD_DIR.mkdir(exist_ok=True)
+    engine = ROOT / "cpp" / "engine"
+    sources = [s for s in sorted(engine.glob("*.cpp")) if not s.name.endswith("_main.cpp")]
+    sources.append(engine / "testing_main.cpp")
+    cmd = ["g++", "-std=c++17", "-O2", "-pthread", "-o", str(CPP_BINARY)] + [str(s) for s in sources]
+    subprocess.check_call(cmd)
+
+
+def load_connections():
+    world = World()
+    world.load(AREAS, CONNECT)
+    return {t.name: {c.name for c in t.connect} for t in world.territories.values()}
+
+
+def hops_from(connect, src):
+    hops = {src: 0}
+    queue = deque([src])
+    while queue:
+        here = queue.popleft()
+        for there in connect[here]:
+            if there not in hops:
+                hops[there] = hops[here] + 1
+                queue.append(there)
+    return hops
+
+
+def costs_from(connect, forces, src, allowed):
+    costs = {src: 0}
+    heap = [(0, src)]
+    while heap:
+        cost, here = heapq.heappop(heap)
+        if cost != costs[here]:
+            continue
+        for there in connect[here]:
+            if there in allowed and cost + forces[there] < costs.get(there, float("inf")):
+                costs[there] = cost + forces[there]
+                heapq.heappush(heap, (costs[there], there))
+    return costs
+
+
+def check_walk(connect, walk, src, dst, label):
+    assert walk[0] == src and walk[-1] == dst, f"{label}: {walk} does not join {src} to {dst}"
+    for a, b in zip(walk, walk[1:]):
+        assert b in connect[a], f"{label}: {a} and {b} are not adjacent"
+
+
+def check_seed(connect, seed):
+    lines = subprocess.check_output([str(CPP_BINARY), "--paths", str(seed)], text=True).splitlines()
+    owners, forces = {}, {}
+    queries = []
+    for line in lines:
+        fields = line.split("\t")
+        if fields[0] == "T":
+            owners[fields[1]] = fields[2]
+            forces[fields[1]] = int(fields[3])
+        else:
+            queries.append(fields[1:])
+    assert set(owners) == set(connect), "C++ map differs from world.py"
+    assert len(queries) == len(connect) ** 2, f"expected {len(connect) ** 2} queries, got {len(queries)}"
+
+    everywhere = set(connect)
+    not_a = {t for t in connect if owners[t] != "A"}
+    hops, costs, avoiding = {}, {}, {}
+    for src in connect:
+        hops[src] = hops_from(connect, src)
+        costs[src] = costs_from(connect, forces, src, everywhere)
+        avoiding[src] = costs_from(connect, forces, src, not_a)
+
+    for src, dst, distance, hop, route, cost, path, avoid_cost, avoid_path in queries:
+        label = f"seed {seed} {src} -> {dst}"
+        expected = hops[src].get(dst, -1)
+        assert int(distance) == expected, f"{label}: distance {distance}, expected {expected}"
+        route = route.split(",") if route else []
+        if expected < 0:
+            assert not route and hop == "-", f"{label}: route to an unreachable territory"
+        else:
+            assert len(route) == expected + 1, f"{label}: route {route} is not shortest"
+            check_walk(connect, route, src, dst, label)
+            assert hop == (route[1] if expected > 0 else "-"), f"{label}: next hop {hop}"
+
+        for found, walk, reference, kind in ((cost, path, costs, "path"),
+                                            (avoid_cost, avoid_path, avoiding, "path avoiding A")):
+            found = int(found)
+            walk = walk.split(",") if walk else []
+            expected = reference[src].get(dst, -1)
+            assert found == expected, f"{label}: {kind} costs {found}, expected {expected}"
+            if expected < 0:
+                assert not walk, f"{label}: {kind} to an unreachable territory"
+                continue
+            check_walk(connect, walk, src, dst, f"{label} {kind}")
+            assert sum(forces[t] for t in walk[1:]) == found, f"{label}: {kind} {walk} miscosted"
+            if reference is avoiding:
+                assert all(owners[t] != "A" for t in walk[1:]), f"{label}: {kind} crosses A"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--seeds", type=int, default=20, help="random boards to check")
+    args = parser.parse_args()
+
+    if is_stale(CPP_BINARY):
+        build_cpp_tester()
+    connect = load_connections()
+    for seed in range(args.seeds):
+        check_seed(connect, seed)
+    print(f"Paths match the reference search on {args.seeds} boards")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,65 @@
+"""Send good and malformed request lines to the C++ game server.
+
+Every line gets one frame back, in order: a game frame for a good request and
+an error frame naming the problem for a bad one. Numbers must be plain
+digits in range, so a seed of -1 or one past 2^32 - 1 is refused instead of
+wrapping to another game.
+"""
+import subprocess
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+BUILD_DIR = ROOT / "build"
+SERVER_BINARY = BUILD_DIR / "pyrisk_server"
+PLAYERS = "players=ALPHA:DeterministicAI,BRAVO:DeterministicAI"
+
+# (request line, start of a game frame or the message of an error frame).
+# A line that fails to parse is answered under its line number, not its id.
+CASES = [
+    (f"id=top {PLAYERS} seed=4294967295", "# game top "),
+    (f"id=zero {PLAYERS} seed=0", "# game zero "),
+    (f"{PLAYERS} seed=4294967296", "seed must be at most 4294967295"),
+    (f"{PLAYERS} seed=99999999999999999999", "bad number for seed"),
+    (f"{PLAYERS} seed=-1", "bad number for seed: -1"),
+    (f"{PLAYERS} seed=+1", "bad number for seed: +1"),
+    (f"{PLAYERS} max_turns=-5", "bad number for max_turns: -5"),
+    (f"{PLAYERS} seed=", "bad number for seed:"),
+]
+
+
+def is_stale(binary):
+    """True when `binary` is missing or older than any engine source."""
+    if not binary.exists():
+        return True
+    built = binary.stat().st_mtime
+    engine = ROOT / "cpp" / "engine"
+    return any(s.stat().st_mtime > built for s in engine.iterdir() if s.suffix in (".cpp", ".hpp"))
+
+
+def build_server():
+    BUILD_DIR.mkdir(exist_ok=True)
+    engine = ROOT / "cpp" / "engine"
+    sources = [s for s in sorted(engine.glob("*.cpp")) if not s.name.endswith("_main.cpp")]
+    sources.append(engine / "server_main.cpp")
+    cmd = ["g++", "-std=c++17", "-O2", "-pthread", "-o", str(SERVER_BINARY)] + [str(s) for s in sources]
+    subprocess.check_call(cmd)
+
+
+def main():
+    if is_stale(SERVER_BINARY):
+        build_server()
+    result = subprocess.run([str(SERVER_BINARY), "--threads", "2"],
+                            input="".join(line + "\n" for line, _ in CASES),
+                            check=True, capture_output=True, text=True)
+    # Without log=... a game frame is its header alone.
+    headers = result.stdout.splitlines()
+    assert len(headers) == len(CASES), f"expected {len(CASES)} frames, got {headers}"
+    for number, ((line, expected), header) in enumerate(zip(CASES, headers), 1):
+        if not expected.startswith("# game"):
+            expected = f"# error {number} {expected}"
+        assert header.startswith(expected), f"{line!r}: got {header!r}"
+    print(f"Server answered all {len(CASES)} requests as expected")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+"""Load damaged --stats files through the C++ engine.
+
+A tournament writes a statistics file, which this script decodes, breaks in
+several ways and re-encodes. The engine tester must load the good file and
+reject every broken one with an error instead of crashing or reading past a
+table.
+"""
+import subprocess
+from pathlib import Path
+import tempfile
+
+ROOT = Path(__file__).resolve().parent.parent
+BUILD_DIR = ROOT / "build"
+BINARIES = {
+    "pyrisk_engine_tester": "testing_main.cpp",
+    "pyrisk_tournament": "tournament_main.cpp",
+}
+
+
+def is_stale(binary):
+    """True when `binary` is missing or older than any engine source."""
+    if not binary.exists():
+        return True
+    built = binary.stat().st_mtime
+    engine = ROOT / "cpp" / "engine"
+    return any(s.stat().st_mtime > built for s in engine.iterdir() if s.suffix in (".cpp", ".hpp"))
+
+
+def build(binary):
+    BUILD_DIR.mkdir(exist_ok=True)
+    engine = ROOT / "cpp" / "engine"
+    sources = [s for s in sorted(engine.glob("*.cpp")) if not s.name.endswith("_main.cpp")]
+    sources.append(engine / BINARIES[binary])
+    cmd = ["g++", "-std=c++17", "-O2", "-pthread", "-o", str(BUILD_DIR / binary)]
+    subprocess.check_call(cmd + [str(s) for s in sources])
+
+
+def encode_varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        out.append(byte | (0x80 if value else 0))
+        if not value:
+            return bytes(out)
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def varint(self):
+        value, shift = 0, 0
+        while True:
+            byte = self.data[self.pos]
+            self.pos += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    def string(self):
+        size = self.varint()
+        self.pos += size
+        return self.data[self.pos - size:self.pos]
+
+    def counts(self):
+        return [self.varint() for _ in range(self.varint())]
+
+
+def decode(data):
+    """Splits a statistics file into named fields, in file order."""
+    reader = Reader(data)
+    assert data[:4] == b"PRST", "not a statistics file"
+    reader.pos = 4
+    fields = [("version", reader.varint()), ("seats", reader.varint())]
+    fields.append(("territories", [reader.string() for _ in range(reader.varint())]))
+    fields.append(("areas", [reader.string() for _ in range(reader.varint())]))
+    for name in ("games", "no_winner", "adjudicated"):
+        fields.append((name, reader.varint()))
+    fields.append(("wins", reader.counts()))
+    fields.append(("length_rounds", reader.counts()))
+    for name in ("gamma", "offset", "zeros"):
+        fields.append((name, reader.varint()))
+    fields.append(("length_turns", reader.counts()))
+    fields.append(("first_conquest", reader.counts()))
+    fields.append(("no_conquest", reader.varint()))
+    for name in ("round_samples", "territory_holding", "area_holding"):
+        fields.append((name, reader.counts()))
+    assert reader.pos == len(data), "trailing bytes in statistics file"
+    return fields
+
+
+def encode(fields):
+    out = bytearray(b"PRST")
+    for name, value in fields:
+        if name in ("territories", "areas"):
+            out += encode_varint(len(value))
+            for text in value:
+                out += encode_varint(len(text)) + text
+        elif isinstance(value, list):
+            out += encode_varint(len(value))
+            for count in value:
+                out += encode_varint(count)
+        else:
+            out += encode_varint(value)
+    return bytes(out)
+
+
+def changed(fields, name, change):
+    return [(n, change(v) if n == name else v) for n, v in fields]
+
+
+def main():
+    for binary in BINARIES:
+        if is_stale(BUILD_DIR / binary):
+            build(binary)
+    tester = BUILD_DIR / "pyrisk_engine_tester"
+
+    with tempfile.TemporaryDirectory() as scratch:
+        good = Path(scratch) / "good.bin"
+        subprocess.run([str(BUILD_DIR / "pyrisk_tournament"), "--games", "4", "--stats", str(good)],
+                       check=True, capture_output=True)
+        data = good.read_bytes()
+        fields = decode(data)
+        assert encode(fields) == data, "statistics decoder does not round-trip"
+
+        cases = {
+            "truncated": (data[: len(data) // 2], "truncated"),
+            "one seat more": (encode(changed(fields, "seats", lambda n: n + 1)), "do not match"),
+            "one territory fewer": (encode(changed(fields, "territories", lambda v: v[:-1])),
+                                    "do not match"),
+            "short territory table": (encode(changed(fields, "territory_holding", lambda v: v[:-1])),
+                                      "do not match"),
+            "long area table": (encode(changed(fields, "area_holding", lambda v: v + [0])),
+                                "do not match"),
+            "short round samples": (encode(changed(fields, "round_samples", lambda v: v[:1])),
+                                    "do not match"),
+            "huge table length": (encode(fields[:-1]) + encode_varint(1 << 60) + bytes(8),
+                                  "truncated"),
+        }
+
+        result = subprocess.run([str(tester), "--stats", str(good)], capture_output=True, text=True)
+        assert result.returncode == 0, f"good file rejected: {result.stderr.strip()}"
+        for description, (content, expected) in cases.items():
+            broken = Path(scratch) / "broken.bin"
+            broken.write_bytes(content)
+            result = subprocess.run([str(tester), "--stats", str(broken)], capture_output=True,
+                                    text=True)
+            assert result.returncode == 1, f"{description}: exited with {result.returncode}"
+            assert expected in result.stderr, f"{description}: {result.stderr.strip()}"
+    print(f"Statistics loader rejected all {len(cases)} damaged files")
+
+
+if __name__ == "__main__":
+    main()